@@ -0,0 +1,428 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetDeletionService.h"
+
+#include "AssetReferenceIndex.h"
+#include "DebugHeader.h"
+#include "ISourceControlModule.h"
+#include "ObjectTools.h"
+#include "PackageTools.h"
+#include "SourceControlHelpers.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopedSlowTask.h"
+#include "UObject/Package.h"
+
+/**
+ * @brief 批量删除资产，返回每个资产的结果
+ * @param AssetsToDelete 要删除的资产
+ * @param ReferenceIndex 已经建立的反向依赖索引
+ * @param Options 删除选项
+ * @return 与 AssetsToDelete 一一对应的结果
+ */
+TArray<EAssetDeletionResult> FAssetDeletionService::DeleteAssets(const TArray<FAssetData>& AssetsToDelete,
+	const FAssetReferenceIndex& ReferenceIndex, const FAssetDeletionOptions& Options)
+{
+	TArray<EAssetDeletionResult> Results;
+	Results.Init(EAssetDeletionResult::Cancelled, AssetsToDelete.Num());
+
+	if (AssetsToDelete.Num() == 0)
+	{
+		return Results;
+	}
+
+	TArray<int32> UnreferencedIndices;
+	TArray<int32> ReferencedIndices;
+	TMap<FName, TArray<FName>> InSetReferencers;
+	PartitionByReferences(AssetsToDelete, ReferenceIndex, UnreferencedIndices, ReferencedIndices, InSetReferencers);
+
+	if (Options.bOnlyUnreferenced)
+	{
+		for (const int32 AssetIndex : ReferencedIndices)
+		{
+			Results[AssetIndex] = EAssetDeletionResult::Referenced;
+		}
+		ReferencedIndices.Reset();
+	}
+
+	if (Options.bShowConfirmation && UnreferencedIndices.Num() > 0)
+	{
+		FString ConfirmMessage = TEXT("Delete ") + FString::FromInt(UnreferencedIndices.Num()) + TEXT(" unreferenced assets?");
+		if (ReferencedIndices.Num() > 0)
+		{
+			ConfirmMessage += TEXT("\n") + FString::FromInt(ReferencedIndices.Num()) + TEXT(" referenced assets will be shown in the delete dialog afterwards.");
+		}
+
+		if (Debug::ShowMsgDialog(EAppMsgType::YesNo, ConfirmMessage, false) != EAppReturnType::Yes)
+		{
+			return Results;
+		}
+	}
+
+	// 未引用的资产分块加载和删除，块与块之间回收垃圾，避免一次加载全部资产
+	TArray<TArray<int32>> Batches;
+	BuildDeletionBatches(AssetsToDelete, UnreferencedIndices, InSetReferencers, Batches);
+	const int32 NumBatches = Batches.Num();
+
+	FScopedSlowTask SlowTask(NumBatches, FText::FromString(TEXT("Deleting assets...")));
+	SlowTask.MakeDialogDelayed(1.f, true);
+
+	for (int32 BatchIndex = 0; BatchIndex < NumBatches; ++BatchIndex)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			break;
+		}
+		SlowTask.EnterProgressFrame(1.f, FText::FromString(FString::Printf(TEXT("Deleting assets (batch %d of %d)..."), BatchIndex + 1, NumBatches)));
+
+		const TArray<int32>& BatchIndices = Batches[BatchIndex];
+		TArray<FAssetData> BatchAssetsDataToLoad;
+		if (Options.bDeleteWithoutLoading)
+		{
+			DeleteBatchWithoutLoading(AssetsToDelete, BatchIndices, BatchAssetsDataToLoad);
+		}
+		else
+		{
+			BatchAssetsDataToLoad.Reserve(BatchIndices.Num());
+			for (const int32 AssetIndex : BatchIndices)
+			{
+				BatchAssetsDataToLoad.Add(AssetsToDelete[AssetIndex]);
+			}
+		}
+
+		if (BatchAssetsDataToLoad.Num() > 0)
+		{
+			ObjectTools::DeleteAssets(BatchAssetsDataToLoad, false);
+		}
+		UpdateResults(AssetsToDelete, BatchIndices, Results);
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	// 被引用的资产需要用户决定是否替换引用或强制删除，交给引擎的删除对话框一次处理
+	if (ReferencedIndices.Num() > 0 && !SlowTask.ShouldCancel())
+	{
+		TArray<FAssetData> ReferencedAssetsData;
+		ReferencedAssetsData.Reserve(ReferencedIndices.Num());
+		for (const int32 AssetIndex : ReferencedIndices)
+		{
+			ReferencedAssetsData.Add(AssetsToDelete[AssetIndex]);
+		}
+
+		ObjectTools::DeleteAssets(ReferencedAssetsData, true);
+		UpdateResults(AssetsToDelete, ReferencedIndices, Results);
+	}
+
+	return Results;
+}
+
+int32 FAssetDeletionService::CountResults(const TArray<EAssetDeletionResult>& Results, EAssetDeletionResult Result)
+{
+	int32 Count = 0;
+	for (const EAssetDeletionResult AssetResult : Results)
+	{
+		Count += AssetResult == Result ? 1 : 0;
+	}
+	return Count;
+}
+
+/**
+ * @brief 按引用情况分组
+ * 索引中引用数为 0 的直接视为未引用；有引用的再向注册表确认引用者是否都在待删除集合内
+ * 被集合外引用的资产不会在分块删除中删除，它引用的集合内资产（以及间接引用的）也一并视为被引用
+ * @param OutInSetReferencers 未引用资产的包 -> 集合内的引用者包，用于排定删除顺序
+ */
+void FAssetDeletionService::PartitionByReferences(const TArray<FAssetData>& AssetsToDelete, const FAssetReferenceIndex& ReferenceIndex,
+	TArray<int32>& OutUnreferencedIndices, TArray<int32>& OutReferencedIndices, TMap<FName, TArray<FName>>& OutInSetReferencers)
+{
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TSet<FName> PackageNamesToDelete;
+	PackageNamesToDelete.Reserve(AssetsToDelete.Num());
+	for (const FAssetData& AssetData : AssetsToDelete)
+	{
+		PackageNamesToDelete.Add(AssetData.PackageName);
+	}
+
+	// 引用者包 -> 它引用的集合内的包，用于把“被引用”沿引用方向传播
+	TMap<FName, TArray<FName>> InSetReferencedPackages;
+	TSet<FName> ReferencedPackageNames;
+	TArray<FName> ReferencerPackageNames;
+
+	for (const FName PackageName : PackageNamesToDelete)
+	{
+		bool bIsUnreferenced = false;
+		if (ReferenceIndex.TryGetIsPackageUnreferenced(PackageName, bIsUnreferenced) && bIsUnreferenced)
+		{
+			continue;
+		}
+
+		ReferencerPackageNames.Reset();
+		AssetRegistry.GetReferencers(PackageName, ReferencerPackageNames);
+
+		TArray<FName> InSetReferencerPackageNames;
+		bool bReferencedFromOutside = false;
+		for (const FName ReferencerPackageName : ReferencerPackageNames)
+		{
+			if (ReferencerPackageName == PackageName)
+			{
+				continue;
+			}
+			if (!PackageNamesToDelete.Contains(ReferencerPackageName))
+			{
+				bReferencedFromOutside = true;
+				break;
+			}
+			InSetReferencerPackageNames.AddUnique(ReferencerPackageName);
+		}
+
+		if (bReferencedFromOutside)
+		{
+			ReferencedPackageNames.Add(PackageName);
+			continue;
+		}
+
+		for (const FName ReferencerPackageName : InSetReferencerPackageNames)
+		{
+			InSetReferencedPackages.FindOrAdd(ReferencerPackageName).Add(PackageName);
+		}
+		if (InSetReferencerPackageNames.Num() > 0)
+		{
+			OutInSetReferencers.Add(PackageName, MoveTemp(InSetReferencerPackageNames));
+		}
+	}
+
+	TArray<FName> PackagesToPropagate = ReferencedPackageNames.Array();
+	while (PackagesToPropagate.Num() > 0)
+	{
+		const FName ReferencerPackageName = PackagesToPropagate.Pop(false);
+		if (const TArray<FName>* ReferencedPackages = InSetReferencedPackages.Find(ReferencerPackageName))
+		{
+			for (const FName ReferencedPackageName : *ReferencedPackages)
+			{
+				bool bAlreadyReferenced = false;
+				ReferencedPackageNames.Add(ReferencedPackageName, &bAlreadyReferenced);
+				if (!bAlreadyReferenced)
+				{
+					OutInSetReferencers.Remove(ReferencedPackageName);
+					PackagesToPropagate.Add(ReferencedPackageName);
+				}
+			}
+		}
+	}
+
+	for (int32 AssetIndex = 0; AssetIndex < AssetsToDelete.Num(); ++AssetIndex)
+	{
+		const bool bReferenced = ReferencedPackageNames.Contains(AssetsToDelete[AssetIndex].PackageName);
+		(bReferenced ? OutReferencedIndices : OutUnreferencedIndices).Add(AssetIndex);
+	}
+}
+
+/**
+ * @brief 把未引用的资产分块，引用者所在的包排在被引用的包之前，同一个包的资产总在同一块
+ * 集合内的引用成环时无法排序，环上剩余的包放在最后单独一块，不被块边界拆开
+ * @param OutBatches 每块资产在 AssetsToDelete 中的下标
+ */
+void FAssetDeletionService::BuildDeletionBatches(const TArray<FAssetData>& AssetsToDelete, const TArray<int32>& UnreferencedIndices,
+	const TMap<FName, TArray<FName>>& InSetReferencers, TArray<TArray<int32>>& OutBatches)
+{
+	TArray<FName> PackageNames;
+	TMap<FName, TArray<int32>> PackageAssetIndices;
+	for (const int32 AssetIndex : UnreferencedIndices)
+	{
+		const FName PackageName = AssetsToDelete[AssetIndex].PackageName;
+		TArray<int32>* AssetIndices = PackageAssetIndices.Find(PackageName);
+		if (!AssetIndices)
+		{
+			PackageNames.Add(PackageName);
+			AssetIndices = &PackageAssetIndices.Add(PackageName);
+		}
+		AssetIndices->Add(AssetIndex);
+	}
+
+	// 入度为尚未删除的集合内引用者数量，为 0 时可以删除
+	TMap<FName, int32> NumPendingReferencers;
+	TMap<FName, TArray<FName>> ReferencedPackagesByReferencer;
+	for (const TPair<FName, TArray<FName>>& Referencers : InSetReferencers)
+	{
+		NumPendingReferencers.Add(Referencers.Key, Referencers.Value.Num());
+		for (const FName ReferencerPackageName : Referencers.Value)
+		{
+			ReferencedPackagesByReferencer.FindOrAdd(ReferencerPackageName).Add(Referencers.Key);
+		}
+	}
+
+	TArray<FName> OrderedPackageNames;
+	OrderedPackageNames.Reserve(PackageNames.Num());
+	for (const FName PackageName : PackageNames)
+	{
+		if (NumPendingReferencers.FindRef(PackageName) == 0)
+		{
+			OrderedPackageNames.Add(PackageName);
+		}
+	}
+
+	for (int32 OrderedIndex = 0; OrderedIndex < OrderedPackageNames.Num(); ++OrderedIndex)
+	{
+		if (const TArray<FName>* ReferencedPackages = ReferencedPackagesByReferencer.Find(OrderedPackageNames[OrderedIndex]))
+		{
+			for (const FName ReferencedPackageName : *ReferencedPackages)
+			{
+				int32& NumPending = NumPendingReferencers.FindChecked(ReferencedPackageName);
+				if (--NumPending == 0)
+				{
+					OrderedPackageNames.Add(ReferencedPackageName);
+				}
+			}
+		}
+	}
+
+	TArray<FName> CyclicPackageNames;
+	for (const FName PackageName : PackageNames)
+	{
+		if (NumPendingReferencers.FindRef(PackageName) > 0)
+		{
+			CyclicPackageNames.Add(PackageName);
+		}
+	}
+
+	OutBatches.Reset();
+	for (const FName PackageName : OrderedPackageNames)
+	{
+		if (OutBatches.Num() == 0 || OutBatches.Last().Num() >= DeletionBatchSize)
+		{
+			OutBatches.AddDefaulted();
+		}
+		OutBatches.Last().Append(PackageAssetIndices.FindChecked(PackageName));
+	}
+
+	if (CyclicPackageNames.Num() > 0)
+	{
+		TArray<int32>& CyclicBatch = OutBatches.AddDefaulted_GetRef();
+		for (const FName PackageName : CyclicPackageNames)
+		{
+			CyclicBatch.Append(PackageAssetIndices.FindChecked(PackageName));
+		}
+	}
+}
+
+/**
+ * @brief 不加载资产，直接删除一块未引用资产的包文件
+ * 只有包中的所有资产都在这一块里时才删除整个包文件，否则交回调用方只删除所选资产
+ * 常驻内存的包先卸载，卸载失败（如有未保存的修改）的交回调用方走加载删除的流程
+ * 文件删除后把文件名一次交给注册表重新扫描，由注册表移除资产并广播删除事件
+ * @param OutAssetsDataToLoad 无法直接删除、需要加载后删除的资产
+ */
+void FAssetDeletionService::DeleteBatchWithoutLoading(const TArray<FAssetData>& AssetsToDelete, const TArray<int32>& BatchIndices,
+	TArray<FAssetData>& OutAssetsDataToLoad)
+{
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TSet<FSoftObjectPath> ObjectPathsInBatch;
+	for (const int32 AssetIndex : BatchIndices)
+	{
+		ObjectPathsInBatch.Add(AssetsToDelete[AssetIndex].GetSoftObjectPath());
+	}
+
+	TArray<FName> PackageNamesToDelete;
+	TSet<FName> PackageNamesToLoad;
+	TArray<UPackage*> PackagesToUnload;
+	TArray<FAssetData> PackageAssetsData;
+	for (const int32 AssetIndex : BatchIndices)
+	{
+		const FAssetData& AssetData = AssetsToDelete[AssetIndex];
+		if (PackageNamesToDelete.Contains(AssetData.PackageName) || PackageNamesToLoad.Contains(AssetData.PackageName))
+		{
+			continue;
+		}
+
+		// 包里还有不删除的资产时不能删除包文件
+		PackageAssetsData.Reset();
+		AssetRegistry.GetAssetsByPackageName(AssetData.PackageName, PackageAssetsData, true);
+		const bool bWholePackageInBatch = !PackageAssetsData.ContainsByPredicate([&ObjectPathsInBatch](const FAssetData& PackageAssetData)
+		{
+			return !ObjectPathsInBatch.Contains(PackageAssetData.GetSoftObjectPath());
+		});
+		if (!bWholePackageInBatch)
+		{
+			PackageNamesToLoad.Add(AssetData.PackageName);
+			continue;
+		}
+
+		PackageNamesToDelete.Add(AssetData.PackageName);
+
+		if (UPackage* ResidentPackage = FindPackage(nullptr, *AssetData.PackageName.ToString()))
+		{
+			PackagesToUnload.AddUnique(ResidentPackage);
+		}
+	}
+
+	if (PackagesToUnload.Num() > 0)
+	{
+		FText UnloadErrorMessage;
+		if (!UPackageTools::UnloadPackages(PackagesToUnload, UnloadErrorMessage))
+		{
+			Debug::PrintLog(UnloadErrorMessage.ToString());
+		}
+	}
+
+	TArray<FString> PackageFilenames;
+	for (const FName PackageName : PackageNamesToDelete)
+	{
+		FString PackageFilename;
+		const FString PackageNameString = PackageName.ToString();
+		if (FindPackage(nullptr, *PackageNameString) || !FPackageName::DoesPackageExist(PackageNameString, &PackageFilename))
+		{
+			PackageNamesToLoad.Add(PackageName);
+			continue;
+		}
+
+		PackageFilenames.Add(FPaths::ConvertRelativePathToFull(PackageFilename));
+	}
+
+	// 受版本控制的文件标记为删除，其余的直接从磁盘删除
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (PackageFilenames.Num() > 0 && SourceControlModule.IsEnabled() && SourceControlModule.GetProvider().IsAvailable())
+	{
+		USourceControlHelpers::MarkFilesForDelete(PackageFilenames, true);
+	}
+
+	IFileManager& FileManager = IFileManager::Get();
+	for (const FString& PackageFilename : PackageFilenames)
+	{
+		if (FileManager.FileExists(*PackageFilename))
+		{
+			FileManager.Delete(*PackageFilename, false, true, true);
+		}
+	}
+
+	if (PackageFilenames.Num() > 0)
+	{
+		IAssetRegistry::GetChecked().ScanModifiedAssetFiles(PackageFilenames);
+	}
+
+	for (const int32 AssetIndex : BatchIndices)
+	{
+		if (PackageNamesToLoad.Contains(AssetsToDelete[AssetIndex].PackageName))
+		{
+			OutAssetsDataToLoad.Add(AssetsToDelete[AssetIndex]);
+		}
+	}
+}
+
+/**
+ * @brief 向注册表确认资产是否已经不存在，据此记录结果
+ */
+void FAssetDeletionService::UpdateResults(const TArray<FAssetData>& AssetsToDelete, const TArray<int32>& AssetIndices,
+	TArray<EAssetDeletionResult>& InOutResults)
+{
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	for (const int32 AssetIndex : AssetIndices)
+	{
+		const bool bStillExists = AssetRegistry.GetAssetByObjectPath(AssetsToDelete[AssetIndex].GetSoftObjectPath()).IsValid();
+		InOutResults[AssetIndex] = bStillExists ? EAssetDeletionResult::Failed : EAssetDeletionResult::Deleted;
+	}
+}
@@ -0,0 +1,139 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetReachabilityRoots.h"
+#include "AssetReferenceIndex.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/World.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Settings/ProjectPackagingSettings.h"
+
+/**
+ * @brief 从插件 Config/DefaultSuperManager.ini 的 [Reachability] 读取根规则，没有配置根类型时以地图为根
+ */
+void FAssetReachabilityRoots::LoadFromPluginConfig()
+{
+	RootClassPaths.Reset();
+	RootPathPrefixes.Reset();
+	bPrimaryAssetsAreRoots = true;
+	bAlwaysCookDirectoriesAreRoots = true;
+
+	TArray<FString> RootClassPathStrings;
+
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("SuperManager"));
+	if (Plugin.IsValid())
+	{
+		FConfigFile ConfigFile;
+		ConfigFile.Read(Plugin->GetBaseDir() / TEXT("Config/DefaultSuperManager.ini"));
+
+		ConfigFile.GetArray(TEXT("Reachability"), TEXT("RootClasses"), RootClassPathStrings);
+		ConfigFile.GetArray(TEXT("Reachability"), TEXT("RootPathPrefixes"), RootPathPrefixes);
+		ConfigFile.GetBool(TEXT("Reachability"), TEXT("bPrimaryAssetsAreRoots"), bPrimaryAssetsAreRoots);
+		ConfigFile.GetBool(TEXT("Reachability"), TEXT("bAlwaysCookDirectoriesAreRoots"), bAlwaysCookDirectoriesAreRoots);
+	}
+
+	for (const FString& RootClassPathString : RootClassPathStrings)
+	{
+		const FTopLevelAssetPath RootClassPath(RootClassPathString);
+		if (RootClassPath.IsValid())
+		{
+			RootClassPaths.Add(RootClassPath);
+		}
+	}
+
+	if (RootClassPaths.Num() == 0)
+	{
+		RootClassPaths.Add(UWorld::StaticClass()->GetClassPathName());
+	}
+
+	RootPathPrefixes.RemoveAll([](const FString& PathPrefix) { return PathPrefix.IsEmpty(); });
+}
+
+/**
+ * @brief 收集作为根的资产：根类型的资产（含子类）和 PrimaryAssetId
+ * 同时刷新打包设置中总是烹饪的目录，之后 IsRootPackage 按路径判断
+ * @param OutRootIdentifiers 作为根的引用者
+ */
+void FAssetReachabilityRoots::GatherRootIdentifiers(TArray<FAssetIdentifier>& OutRootIdentifiers)
+{
+	check(IsInGameThread());
+
+	OutRootIdentifiers.Reset();
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TArray<FAssetData> RootAssetsData;
+	for (const FTopLevelAssetPath& RootClassPath : RootClassPaths)
+	{
+		AssetRegistry.GetAssetsByClass(RootClassPath, RootAssetsData, true);
+	}
+
+	for (const FAssetData& RootAssetData : RootAssetsData)
+	{
+		OutRootIdentifiers.Add(FAssetIdentifier(RootAssetData.PackageName));
+	}
+
+	if (bPrimaryAssetsAreRoots)
+	{
+		OutRootIdentifiers.Append(FAssetReferenceIndex::GatherPrimaryAssetReferencers());
+	}
+
+	AlwaysCookPathPrefixes.Reset();
+	if (bAlwaysCookDirectoriesAreRoots)
+	{
+		for (const FDirectoryPath& DirectoryPath : GetDefault<UProjectPackagingSettings>()->DirectoriesToAlwaysCook)
+		{
+			if (!DirectoryPath.Path.IsEmpty())
+			{
+				AlwaysCookPathPrefixes.Add(DirectoryPath.Path);
+			}
+		}
+	}
+}
+
+/**
+ * @brief 按路径判断包是否为根，可以在任意线程调用
+ * @param PackageName 包名
+ * @return /Game 以外的包，以及在根路径前缀或总是烹饪的目录下的包
+ */
+bool FAssetReachabilityRoots::IsRootPackage(FName PackageName) const
+{
+	TStringBuilder<256> PackageNameBuilder;
+	PackageName.ToString(PackageNameBuilder);
+	const FStringView PackagePath = PackageNameBuilder.ToView();
+
+	if (!IsPathUnderPrefix(PackagePath, TEXTVIEW("/Game")))
+	{
+		return true;
+	}
+
+	for (const FString& RootPathPrefix : RootPathPrefixes)
+	{
+		if (IsPathUnderPrefix(PackagePath, RootPathPrefix))
+		{
+			return true;
+		}
+	}
+
+	for (const FString& AlwaysCookPathPrefix : AlwaysCookPathPrefixes)
+	{
+		if (IsPathUnderPrefix(PackagePath, AlwaysCookPathPrefix))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief 按整级匹配前缀，/Game/ThirdParty 不会匹配 /Game/ThirdPartyArt
+ */
+bool FAssetReachabilityRoots::IsPathUnderPrefix(FStringView Path, FStringView Prefix)
+{
+	Prefix.RemoveSuffix(Prefix.EndsWith(TEXT('/')) ? 1 : 0);
+	if (!Path.StartsWith(Prefix, ESearchCase::IgnoreCase))
+	{
+		return false;
+	}
+	return Path.Len() == Prefix.Len() || Path[Prefix.Len()] == TEXT('/');
+}
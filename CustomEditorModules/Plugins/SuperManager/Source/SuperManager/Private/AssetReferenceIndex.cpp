@@ -0,0 +1,772 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "AssetReferenceIndex.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/AssetManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "IO/IoHash.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeRWLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+	/**
+	 * @brief 取注册表记录的包保存哈希，包每次保存都会变化，用来判断快照中的依赖边是否仍然有效
+	 * @return 注册表中没有记录时返回零哈希
+	 */
+	FIoHash GetPackageSavedHash(const IAssetRegistry& AssetRegistry, FName PackageName)
+	{
+		const TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+		return PackageData.IsSet() ? PackageData->PackageSavedHash : FIoHash::Zero;
+	}
+}
+
+/**
+ * @brief 收集 Asset Manager 中所有的 PrimaryAssetId，它们是 Manage 类别依赖边的起点
+ * Asset Manager 不是线程安全的，必须在游戏线程调用
+ * @return PrimaryAssetId 形式的引用者
+ */
+TArray<FAssetIdentifier> FAssetReferenceIndex::GatherPrimaryAssetReferencers()
+{
+	check(IsInGameThread());
+
+	TArray<FAssetIdentifier> PrimaryAssetReferencers;
+	if (!UAssetManager::IsInitialized())
+	{
+		return PrimaryAssetReferencers;
+	}
+
+	UAssetManager& AssetManager = UAssetManager::Get();
+
+	TArray<FPrimaryAssetTypeInfo> PrimaryAssetTypeInfos;
+	AssetManager.GetPrimaryAssetTypeInfoList(PrimaryAssetTypeInfos);
+
+	for (const FPrimaryAssetTypeInfo& TypeInfo : PrimaryAssetTypeInfos)
+	{
+		TArray<FPrimaryAssetId> PrimaryAssetIds;
+		AssetManager.GetPrimaryAssetIdList(TypeInfo.PrimaryAssetType, PrimaryAssetIds);
+
+		for (const FPrimaryAssetId& PrimaryAssetId : PrimaryAssetIds)
+		{
+			PrimaryAssetReferencers.Add(FAssetIdentifier(PrimaryAssetId));
+		}
+	}
+
+	return PrimaryAssetReferencers;
+}
+
+/**
+ * @brief 编辑器中 Asset Manager 要等注册表扫描完成后才会完成初始扫描，在此之前 PrimaryAssetId 列表是空的或不完整的
+ * 必须在游戏线程调用
+ */
+bool FAssetReferenceIndex::HasAssetManagerCompletedInitialScan()
+{
+	check(IsInGameThread());
+
+	return UAssetManager::IsInitialized() && UAssetManager::Get().HasInitialScanCompleted();
+}
+
+/**
+ * @brief 一次遍历依赖图，建立反向引用计数
+ * @param PrimaryAssetReferencers 由 GatherPrimaryAssetReferencers 在游戏线程收集的 PrimaryAssetId
+ */
+void FAssetReferenceIndex::Build(const TArray<FAssetIdentifier>& PrimaryAssetReferencers)
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	Build_Locked(PrimaryAssetReferencers);
+}
+
+/**
+ * @brief 索引尚未建立时才建立，多个调用者同时请求时只会建立一次
+ * @param PrimaryAssetReferencers 由 GatherPrimaryAssetReferencers 在游戏线程收集的 PrimaryAssetId
+ */
+void FAssetReferenceIndex::EnsureBuilt(const TArray<FAssetIdentifier>& PrimaryAssetReferencers)
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	if (!bIsBuilt)
+	{
+		Build_Locked(PrimaryAssetReferencers);
+	}
+}
+
+/**
+ * @brief 撤销索引中所有 PrimaryAssetId 的依赖边，再按给定的 PrimaryAssetId 重新查询
+ * 用于补全 Asset Manager 完成初始扫描前建立的索引，索引尚未建立时不做任何事
+ * @param PrimaryAssetReferencers 由 GatherPrimaryAssetReferencers 在游戏线程收集的 PrimaryAssetId
+ */
+void FAssetReferenceIndex::ReplacePrimaryAssetReferencers(const TArray<FAssetIdentifier>& PrimaryAssetReferencers)
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	if (!bIsBuilt)
+	{
+		return;
+	}
+
+	TArray<FAssetIdentifier> OldPrimaryAssetReferencers;
+	for (const TPair<FAssetIdentifier, FReferenceEdges>& ReferencerEdges : ForwardEdgesMap)
+	{
+		if (ReferencerEdges.Key.GetPrimaryAssetId().IsValid())
+		{
+			OldPrimaryAssetReferencers.Add(ReferencerEdges.Key);
+		}
+	}
+
+	for (const FAssetIdentifier& OldPrimaryAssetReferencer : OldPrimaryAssetReferencers)
+	{
+		RemoveReferencesFrom(OldPrimaryAssetReferencer);
+	}
+
+	QueryAndAddReferenceEdges_Locked(PrimaryAssetReferencers);
+}
+
+void FAssetReferenceIndex::Build_Locked(const TArray<FAssetIdentifier>& PrimaryAssetReferencers)
+{
+	ReferencerCountsMap.Reset();
+	ForwardEdgesMap.Reset();
+
+	// 建立索引会读取注册表的最新状态，此前标记失效的包不再需要重算
+	{
+		FScopeLock InvalidatedLock(&InvalidatedPackagesLock);
+		InvalidatedPackageNames.Reset();
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	const TSet<FName> AllPackageNames = GatherAllPackageNames(AssetRegistry);
+
+	// 包和 PrimaryAssetId 都作为引用者
+	TArray<FAssetIdentifier> Referencers;
+	Referencers.Reserve(AllPackageNames.Num() + PrimaryAssetReferencers.Num());
+	for (const FName& PackageName : AllPackageNames)
+	{
+		Referencers.Add(FAssetIdentifier(PackageName));
+	}
+	Referencers.Append(PrimaryAssetReferencers);
+
+	ReferencerCountsMap.Reserve(AllPackageNames.Num());
+	ForwardEdgesMap.Reserve(Referencers.Num());
+	QueryAndAddReferenceEdges_Locked(Referencers);
+
+	bIsBuilt = true;
+}
+
+/**
+ * @brief 收集所有包名，一个包可能包含多个资产，需要去重
+ * 只枚举磁盘上的资产，内存中的资产只能在游戏线程枚举
+ */
+TSet<FName> FAssetReferenceIndex::GatherAllPackageNames(const IAssetRegistry& AssetRegistry)
+{
+	TSet<FName> AllPackageNames;
+	AssetRegistry.EnumerateAllAssets([&AllPackageNames](const FAssetData& AssetData)
+	{
+		AllPackageNames.Add(AssetData.PackageName);
+		return true;
+	}, true);
+
+	return AllPackageNames;
+}
+
+/**
+ * @brief 并行查询一组引用者的正向依赖，再单线程合并到索引中，调用者需持有写锁
+ * @param Referencers 引用者，可以是包，也可以是 PrimaryAssetId
+ */
+void FAssetReferenceIndex::QueryAndAddReferenceEdges_Locked(const TArray<FAssetIdentifier>& Referencers)
+{
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	// 注册表查询是线程安全的，按块分给工作线程，每块写入自己的结果数组，不需要加锁
+	const int32 NumReferencers = Referencers.Num();
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumReferencers, BuildChunkSize);
+
+	TArray<TArray<FReferenceEdges>> ChunkEdges;
+	ChunkEdges.SetNum(NumChunks);
+
+	ParallelFor(NumChunks, [&Referencers, &ChunkEdges, &AssetRegistry, NumReferencers](int32 ChunkIndex)
+	{
+		const int32 ChunkStart = ChunkIndex * BuildChunkSize;
+		const int32 ChunkEnd = FMath::Min(ChunkStart + BuildChunkSize, NumReferencers);
+
+		TArray<FReferenceEdges>& EdgesOfChunk = ChunkEdges[ChunkIndex];
+		EdgesOfChunk.Reserve(ChunkEnd - ChunkStart);
+
+		for (int32 ReferencerIndex = ChunkStart; ReferencerIndex < ChunkEnd; ++ReferencerIndex)
+		{
+			EdgesOfChunk.Add(QueryReferenceEdges(Referencers[ReferencerIndex], AssetRegistry));
+		}
+	});
+
+	// 单线程合并，沿正向依赖边给被引用的包计数
+	for (int32 ChunkIndex = 0; ChunkIndex < NumChunks; ++ChunkIndex)
+	{
+		TArray<FReferenceEdges>& EdgesOfChunk = ChunkEdges[ChunkIndex];
+		for (int32 EdgesIndex = 0; EdgesIndex < EdgesOfChunk.Num(); ++EdgesIndex)
+		{
+			AddReferenceEdges(Referencers[ChunkIndex * BuildChunkSize + EdgesIndex], MoveTemp(EdgesOfChunk[EdgesIndex]));
+		}
+		EdgesOfChunk.Empty();
+	}
+}
+
+void FAssetReferenceIndex::Reset()
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	ReferencerCountsMap.Reset();
+	ForwardEdgesMap.Reset();
+	bIsBuilt = false;
+
+	FScopeLock InvalidatedLock(&InvalidatedPackagesLock);
+	InvalidatedPackageNames.Reset();
+}
+
+/**
+ * @brief 从快照恢复索引，只有保存哈希与注册表一致的包沿用快照中的依赖边，其余的包和 PrimaryAssetId 重新查询
+ * 快照文件以只读方式映射到内存后直接解析，平台不支持映射时整体读入
+ * 索引已经建立时不做任何事
+ * @param Filename 快照文件
+ * @param PrimaryAssetReferencers 由 GatherPrimaryAssetReferencers 在游戏线程收集的 PrimaryAssetId
+ * @return 快照有效并且索引已经建立
+ */
+bool FAssetReferenceIndex::LoadSnapshot(const FString& Filename, const TArray<FAssetIdentifier>& PrimaryAssetReferencers)
+{
+	FWriteScopeLock WriteLock(IndexLock);
+	if (bIsBuilt)
+	{
+		return true;
+	}
+
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion() : nullptr);
+
+	TArray<uint8> FileData;
+	TArrayView<const uint8> SnapshotView;
+	if (MappedRegion.IsValid())
+	{
+		SnapshotView = TArrayView<const uint8>(MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize());
+	}
+	else if (FFileHelper::LoadFileToArray(FileData, *Filename, FILEREAD_Silent))
+	{
+		SnapshotView = FileData;
+	}
+	else
+	{
+		return false;
+	}
+
+	FMemoryReaderView Reader(SnapshotView);
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != SnapshotMagic || Version != SnapshotVersion)
+	{
+		return false;
+	}
+
+	// 名称表，依赖边中只保存名称表下标
+	int32 NumNames = 0;
+	Reader << NumNames;
+	if (Reader.IsError() || NumNames < 0 || NumNames > Reader.TotalSize())
+	{
+		return false;
+	}
+
+	TArray<FName> Names;
+	Names.Reserve(NumNames);
+	for (int32 NameIndex = 0; NameIndex < NumNames && !Reader.IsError(); ++NameIndex)
+	{
+		FString NameString;
+		Reader << NameString;
+		Names.Add(FName(*NameString));
+	}
+
+	ReferencerCountsMap.Reset();
+	ForwardEdgesMap.Reset();
+	{
+		FScopeLock InvalidatedLock(&InvalidatedPackagesLock);
+		InvalidatedPackageNames.Reset();
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TSet<FName> PackageNamesToQuery = GatherAllPackageNames(AssetRegistry);
+	ReferencerCountsMap.Reserve(PackageNamesToQuery.Num());
+	ForwardEdgesMap.Reserve(PackageNamesToQuery.Num() + PrimaryAssetReferencers.Num());
+
+	auto ReadName = [&Reader, &Names](FName& OutName)
+	{
+		int32 NameIndex = INDEX_NONE;
+		Reader << NameIndex;
+		if (!Names.IsValidIndex(NameIndex))
+		{
+			Reader.SetError();
+			return;
+		}
+		OutName = Names[NameIndex];
+	};
+
+	int32 NumEntries = 0;
+	Reader << NumEntries;
+	for (int32 EntryIndex = 0; EntryIndex < NumEntries && !Reader.IsError(); ++EntryIndex)
+	{
+		FName PackageName;
+		FIoHash SavedHash;
+		FReferenceEdges Edges;
+
+		ReadName(PackageName);
+		Reader << SavedHash;
+		for (int32 KindIndex = 0; KindIndex < static_cast<int32>(EAssetReferenceKind::Num) && !Reader.IsError(); ++KindIndex)
+		{
+			int32 NumEdges = 0;
+			Reader << NumEdges;
+			if (NumEdges < 0 || NumEdges > NumNames)
+			{
+				Reader.SetError();
+				break;
+			}
+
+			TArray<FName>& ReferencedPackageNames = Edges.ReferencedPackageNames[KindIndex];
+			ReferencedPackageNames.SetNum(NumEdges);
+			for (int32 EdgeIndex = 0; EdgeIndex < NumEdges && !Reader.IsError(); ++EdgeIndex)
+			{
+				ReadName(ReferencedPackageNames[EdgeIndex]);
+			}
+		}
+
+		// 已删除的包和保存后又修改过的包不沿用快照
+		if (!Reader.IsError() && !SavedHash.IsZero() && PackageNamesToQuery.Contains(PackageName)
+			&& GetPackageSavedHash(AssetRegistry, PackageName) == SavedHash)
+		{
+			PackageNamesToQuery.Remove(PackageName);
+			AddReferenceEdges(FAssetIdentifier(PackageName), MoveTemp(Edges));
+		}
+	}
+
+	if (Reader.IsError())
+	{
+		ReferencerCountsMap.Reset();
+		ForwardEdgesMap.Reset();
+		return false;
+	}
+
+	// 快照之外的包和 PrimaryAssetId 重新查询，后者数量很少并且可能随 Asset Manager 配置变化
+	TArray<FAssetIdentifier> Referencers;
+	Referencers.Reserve(PackageNamesToQuery.Num() + PrimaryAssetReferencers.Num());
+	for (const FName& PackageName : PackageNamesToQuery)
+	{
+		Referencers.Add(FAssetIdentifier(PackageName));
+	}
+	Referencers.Append(PrimaryAssetReferencers);
+	QueryAndAddReferenceEdges_Locked(Referencers);
+
+	bIsBuilt = true;
+	return true;
+}
+
+/**
+ * @brief 把包的正向依赖边连同注册表中的保存哈希写入快照，PrimaryAssetId 的依赖边不保存
+ * 写入前先重算失效的包，保证保存的依赖边与保存哈希对应
+ * @param Filename 快照文件
+ * @return 写入成功
+ */
+bool FAssetReferenceIndex::SaveSnapshot(const FString& Filename)
+{
+	RefreshInvalidatedPackages();
+
+	FReadScopeLock ReadLock(IndexLock);
+	if (!bIsBuilt)
+	{
+		return false;
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TArray<FName> Names;
+	TMap<FName, int32> NameIndices;
+	auto GetNameIndex = [&Names, &NameIndices](FName Name)
+	{
+		if (const int32* FoundIndex = NameIndices.Find(Name))
+		{
+			return *FoundIndex;
+		}
+		return NameIndices.Add(Name, Names.Add(Name));
+	};
+
+	// 名称表写在条目之前，而名称是遍历条目时才收集到的，所以条目先写入单独的缓冲区，最后再拼接
+	TArray<uint8> EntriesData;
+	FMemoryWriter EntriesWriter(EntriesData);
+
+	int32 NumEntries = 0;
+	for (const TPair<FAssetIdentifier, FReferenceEdges>& Pair : ForwardEdgesMap)
+	{
+		if (!Pair.Key.IsPackage())
+		{
+			continue;
+		}
+
+		FIoHash SavedHash = GetPackageSavedHash(AssetRegistry, Pair.Key.PackageName);
+		if (SavedHash.IsZero())
+		{
+			continue;
+		}
+
+		int32 PackageNameIndex = GetNameIndex(Pair.Key.PackageName);
+		EntriesWriter << PackageNameIndex << SavedHash;
+		for (int32 KindIndex = 0; KindIndex < static_cast<int32>(EAssetReferenceKind::Num); ++KindIndex)
+		{
+			const TArray<FName>& ReferencedPackageNames = Pair.Value.ReferencedPackageNames[KindIndex];
+			int32 NumEdges = ReferencedPackageNames.Num();
+			EntriesWriter << NumEdges;
+			for (const FName& ReferencedPackageName : ReferencedPackageNames)
+			{
+				int32 ReferencedNameIndex = GetNameIndex(ReferencedPackageName);
+				EntriesWriter << ReferencedNameIndex;
+			}
+		}
+		++NumEntries;
+	}
+
+	TArray<uint8> SnapshotData;
+	FMemoryWriter Writer(SnapshotData);
+
+	uint32 Magic = SnapshotMagic;
+	uint32 Version = SnapshotVersion;
+	int32 NumNames = Names.Num();
+	Writer << Magic << Version << NumNames;
+	for (const FName& Name : Names)
+	{
+		FString NameString = Name.ToString();
+		Writer << NameString;
+	}
+	Writer << NumEntries;
+	Writer.Serialize(EntriesData.GetData(), EntriesData.Num());
+
+	return FFileHelper::SaveArrayToFile(SnapshotData, *Filename);
+}
+
+/**
+ * @brief 标记一个包需要重算，可以在任意线程调用
+ * @param PackageName 发生变化的包
+ */
+void FAssetReferenceIndex::InvalidatePackage(FName PackageName)
+{
+	if (PackageName.IsNone())
+	{
+		return;
+	}
+
+	FScopeLock InvalidatedLock(&InvalidatedPackagesLock);
+	InvalidatedPackageNames.Add(PackageName);
+}
+
+/**
+ * @brief 按包增量更新：撤销失效包原有的正向依赖边，再按注册表当前状态重新添加
+ * 已被删除的包只撤销，并从索引中移除，之后按未被索引的包处理
+ */
+void FAssetReferenceIndex::RefreshInvalidatedPackages()
+{
+	TSet<FName> PackageNamesToRefresh;
+	{
+		FScopeLock InvalidatedLock(&InvalidatedPackagesLock);
+		PackageNamesToRefresh = MoveTemp(InvalidatedPackageNames);
+		InvalidatedPackageNames.Reset();
+	}
+
+	if (PackageNamesToRefresh.Num() == 0)
+	{
+		return;
+	}
+
+	FWriteScopeLock WriteLock(IndexLock);
+	if (!bIsBuilt)
+	{
+		return;
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TArray<FAssetData> PackageAssetsData;
+
+	for (const FName& PackageName : PackageNamesToRefresh)
+	{
+		const FAssetIdentifier Referencer(PackageName);
+		RemoveReferencesFrom(Referencer);
+
+		// 磁盘上已经没有资产的包（已删除或只在内存中）不再作为引用者留在索引中，与建立索引时只枚举磁盘上的资产一致
+		PackageAssetsData.Reset();
+		AssetRegistry.GetAssetsByPackageName(PackageName, PackageAssetsData, true);
+		if (PackageAssetsData.Num() == 0)
+		{
+			continue;
+		}
+
+		AddReferenceEdges(Referencer, QueryReferenceEdges(Referencer, AssetRegistry));
+	}
+}
+
+bool FAssetReferenceIndex::IsBuilt() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return bIsBuilt;
+}
+
+int32 FAssetReferenceIndex::NumIndexedPackages() const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return ReferencerCountsMap.Num();
+}
+
+FPackageReferencerCounts FAssetReferenceIndex::GetReferencerCounts(FName PackageName) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	if (const FPackageReferencerCounts* FoundCounts = ReferencerCountsMap.Find(PackageName))
+	{
+		return *FoundCounts;
+	}
+	return FPackageReferencerCounts();
+}
+
+int32 FAssetReferenceIndex::GetReferencerCount(FName PackageName, EAssetReferenceKind Kind) const
+{
+	return GetReferencerCounts(PackageName).Get(Kind);
+}
+
+bool FAssetReferenceIndex::IsPackageUnreferenced(FName PackageName) const
+{
+	return GetReferencerCounts(PackageName).GetPackageReferencerCount() == 0;
+}
+
+/**
+ * @brief 包是否作为引用者被索引过，未被索引的包（如尚未保存的新资产）需要直接查询注册表
+ * @param PackageName 包名
+ * @return 
+ */
+bool FAssetReferenceIndex::IsPackageIndexed(FName PackageName) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	return ForwardEdgesMap.Contains(FAssetIdentifier(PackageName));
+}
+
+/**
+ * @brief 在同一次读锁内判断包是否被索引以及是否未被引用，两次读取看到的是同一个索引状态
+ * @param PackageName 包名
+ * @param bOutIsUnreferenced 包被索引时输出是否没有引用者
+ * @return 包是否作为引用者被索引过
+ */
+bool FAssetReferenceIndex::TryGetIsPackageUnreferenced(FName PackageName, bool& bOutIsUnreferenced) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+	if (!ForwardEdgesMap.Contains(FAssetIdentifier(PackageName)))
+	{
+		return false;
+	}
+
+	const FPackageReferencerCounts* FoundCounts = ReferencerCountsMap.Find(PackageName);
+	bOutIsUnreferenced = !FoundCounts || FoundCounts->GetPackageReferencerCount() == 0;
+	return true;
+}
+
+/**
+ * @brief 所有查找未使用资产的入口共用的判断，与删除时 PartitionByReferences 的口径一致
+ * 被索引的包查索引；未被索引的包（如尚未保存的新资产）直接向注册表查询，可以在任意线程调用
+ * @param PackageName 包名
+ * @return 包没有除自身以外的 Package 类别引用者
+ */
+bool FAssetReferenceIndex::IsPackageUnused(FName PackageName) const
+{
+	bool bIsUnreferenced = false;
+	if (TryGetIsPackageUnreferenced(PackageName, bIsUnreferenced))
+	{
+		return bIsUnreferenced;
+	}
+
+	TArray<FName> ReferencerPackageNames;
+	IAssetRegistry::GetChecked().GetReferencers(PackageName, ReferencerPackageNames);
+	ReferencerPackageNames.Remove(PackageName);
+	return ReferencerPackageNames.Num() == 0;
+}
+
+/**
+ * @brief 从根出发沿正向依赖边遍历一次，得到所有可达的包
+ * 所有引用类型的边都会被遍历，宁可多保留也不误删
+ * @param RootIdentifiers 作为根的引用者，如地图包和 PrimaryAssetId
+ * @param IsRootPackage 对索引中的每个包调用一次，返回 true 的包也作为根
+ * @param OutReachablePackageNames 可达的包，包含作为根的包
+ */
+void FAssetReferenceIndex::FindReachablePackages(const TArray<FAssetIdentifier>& RootIdentifiers, TFunctionRef<bool(FName PackageName)> IsRootPackage,
+	TSet<FName>& OutReachablePackageNames) const
+{
+	FReadScopeLock ReadLock(IndexLock);
+
+	OutReachablePackageNames.Reset();
+	OutReachablePackageNames.Reserve(ForwardEdgesMap.Num());
+
+	// 待访问的引用者，包以外的根（PrimaryAssetId）只会作为起点出现
+	TArray<FAssetIdentifier> PendingReferencers;
+	for (const FAssetIdentifier& RootIdentifier : RootIdentifiers)
+	{
+		if (!RootIdentifier.IsPackage())
+		{
+			PendingReferencers.Add(RootIdentifier);
+		}
+		else if (!OutReachablePackageNames.Contains(RootIdentifier.PackageName))
+		{
+			OutReachablePackageNames.Add(RootIdentifier.PackageName);
+			PendingReferencers.Add(RootIdentifier);
+		}
+	}
+
+	for (const TPair<FAssetIdentifier, FReferenceEdges>& Pair : ForwardEdgesMap)
+	{
+		const FName PackageName = Pair.Key.PackageName;
+		if (Pair.Key.IsPackage() && !OutReachablePackageNames.Contains(PackageName) && IsRootPackage(PackageName))
+		{
+			OutReachablePackageNames.Add(PackageName);
+			PendingReferencers.Add(Pair.Key);
+		}
+	}
+
+	while (PendingReferencers.Num() > 0)
+	{
+		const FReferenceEdges* Edges = ForwardEdgesMap.Find(PendingReferencers.Pop(false));
+		if (!Edges)
+		{
+			continue;
+		}
+
+		for (int32 KindIndex = 0; KindIndex < static_cast<int32>(EAssetReferenceKind::Num); ++KindIndex)
+		{
+			for (const FName& ReferencedPackageName : Edges->ReferencedPackageNames[KindIndex])
+			{
+				bool bAlreadyReached = false;
+				OutReachablePackageNames.Add(ReferencedPackageName, &bAlreadyReached);
+				if (!bAlreadyReached)
+				{
+					PendingReferencers.Add(FAssetIdentifier(ReferencedPackageName));
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief 查询一个引用者的所有正向依赖，只读注册表，可以在工作线程并行调用
+ * @param Referencer 引用者，可以是包，也可以是 PrimaryAssetId
+ * @param AssetRegistry 资产注册表
+ * @return 按引用类型分开的依赖边
+ */
+FAssetReferenceIndex::FReferenceEdges FAssetReferenceIndex::QueryReferenceEdges(const FAssetIdentifier& Referencer, const IAssetRegistry& AssetRegistry)
+{
+	using namespace UE::AssetRegistry;
+
+	struct FKindQuery
+	{
+		EAssetReferenceKind Kind;
+		EDependencyCategory Category;
+		EDependencyQuery Query;
+	};
+
+	static const FKindQuery KindQueries[] =
+	{
+		{EAssetReferenceKind::Hard,				EDependencyCategory::Package,			EDependencyQuery::Hard},
+		{EAssetReferenceKind::Soft,				EDependencyCategory::Package,			EDependencyQuery::Soft},
+		{EAssetReferenceKind::SearchableName,	EDependencyCategory::SearchableName,	EDependencyQuery::NoRequirements},
+		{EAssetReferenceKind::Management,		EDependencyCategory::Manage,			EDependencyQuery::NoRequirements},
+	};
+
+	TArray<FAssetIdentifier> Dependencies;
+	TSet<FName> CountedPackageNames;
+	FReferenceEdges Edges;
+
+	for (const FKindQuery& KindQuery : KindQueries)
+	{
+		Dependencies.Reset();
+		CountedPackageNames.Reset();
+		AssetRegistry.GetDependencies(Referencer, Dependencies, KindQuery.Category, KindQuery.Query);
+
+		TArray<FName>& ReferencedPackageNames = Edges.ReferencedPackageNames[static_cast<int32>(KindQuery.Kind)];
+
+		for (const FAssetIdentifier& Dependency : Dependencies)
+		{
+			// 自身引用不算；SearchableName 可能指向同一个包的多个值，每个引用者只计一次
+			if (Dependency.PackageName.IsNone() || Dependency.PackageName == Referencer.PackageName)
+			{
+				continue;
+			}
+
+			bool bAlreadyCounted = false;
+			CountedPackageNames.Add(Dependency.PackageName, &bAlreadyCounted);
+			if (!bAlreadyCounted)
+			{
+				ReferencedPackageNames.Add(Dependency.PackageName);
+			}
+		}
+	}
+
+	return Edges;
+}
+
+/**
+ * @brief 记录一个引用者的正向依赖边，并累加到被引用包的计数上
+ * @param Referencer 引用者
+ * @param Edges 由 QueryReferenceEdges 查询到的依赖边
+ */
+void FAssetReferenceIndex::AddReferenceEdges(const FAssetIdentifier& Referencer, FReferenceEdges&& Edges)
+{
+	for (int32 KindIndex = 0; KindIndex < static_cast<int32>(EAssetReferenceKind::Num); ++KindIndex)
+	{
+		for (const FName& ReferencedPackageName : Edges.ReferencedPackageNames[KindIndex])
+		{
+			AddReference(ReferencedPackageName, static_cast<EAssetReferenceKind>(KindIndex));
+		}
+	}
+
+	ForwardEdgesMap.Add(Referencer, MoveTemp(Edges));
+}
+
+/**
+ * @brief 撤销一个引用者记录过的所有正向依赖边
+ * @param Referencer 引用者
+ */
+void FAssetReferenceIndex::RemoveReferencesFrom(const FAssetIdentifier& Referencer)
+{
+	FReferenceEdges OldEdges;
+	if (!ForwardEdgesMap.RemoveAndCopyValue(Referencer, OldEdges))
+	{
+		return;
+	}
+
+	for (int32 KindIndex = 0; KindIndex < static_cast<int32>(EAssetReferenceKind::Num); ++KindIndex)
+	{
+		for (const FName& ReferencedPackageName : OldEdges.ReferencedPackageNames[KindIndex])
+		{
+			RemoveReference(ReferencedPackageName, static_cast<EAssetReferenceKind>(KindIndex));
+		}
+	}
+}
+
+void FAssetReferenceIndex::AddReference(FName ReferencedPackageName, EAssetReferenceKind Kind)
+{
+	++ReferencerCountsMap.FindOrAdd(ReferencedPackageName).Counts[static_cast<int32>(Kind)];
+}
+
+void FAssetReferenceIndex::RemoveReference(FName ReferencedPackageName, EAssetReferenceKind Kind)
+{
+	if (FPackageReferencerCounts* FoundCounts = ReferencerCountsMap.Find(ReferencedPackageName))
+	{
+		int32& Count = FoundCounts->Counts[static_cast<int32>(Kind)];
+		Count = FMath::Max(Count - 1, 0);
+
+		// 没有记录的包视为零引用，计数全部归零后移除，索引不会随删除操作增长
+		bool bHasReferencers = false;
+		for (const int32 KindCount : FoundCounts->Counts)
+		{
+			bHasReferencers = bHasReferencers || KindCount > 0;
+		}
+		if (!bHasReferencers)
+		{
+			ReferencerCountsMap.Remove(ReferencedPackageName);
+		}
+	}
+}
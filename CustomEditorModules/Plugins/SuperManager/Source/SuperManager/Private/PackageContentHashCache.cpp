@@ -0,0 +1,827 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PackageContentHashCache.h"
+
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Hash/xxhash.h"
+#include "Misc/PackageName.h"
+#include "Serialization/ArchiveProxy.h"
+#include "UObject/ObjectResource.h"
+#include "UObject/PackageFileSummary.h"
+
+namespace
+{
+	/** 按名称表把包文件中的名称下标解析为 FName，用于读取导入表 */
+	class FPackageNameMapReader : public FArchiveProxy
+	{
+	public:
+		FPackageNameMapReader(FArchive& InInnerArchive, const TArray<FName>& InNameMap)
+			: FArchiveProxy(InInnerArchive)
+			, NameMap(InNameMap)
+		{
+		}
+
+		virtual FArchive& operator<<(FName& Name) override
+		{
+			int32 NameIndex = 0;
+			int32 Number = 0;
+			InnerArchive << NameIndex << Number;
+
+			if (!NameMap.IsValidIndex(NameIndex))
+			{
+				SetError();
+				Name = NAME_None;
+				return *this;
+			}
+
+			Name = FName(NameMap[NameIndex], Number);
+			return *this;
+		}
+
+	private:
+		const TArray<FName>& NameMap;
+	};
+
+	void UpdateHashWithString(FXxHash64Builder& HashBuilder, FStringView String)
+	{
+		const int32 Length = String.Len();
+		HashBuilder.Update(&Length, sizeof(Length));
+		HashBuilder.Update(String.GetData(), Length * sizeof(TCHAR));
+	}
+
+	/** 流式读取时每次读取的字节数 */
+	constexpr int64 ReadBufferSize = 256 * 1024;
+
+	/**
+	 * @brief 从当前位置流式读取 Size 个字节加入哈希
+	 * @return 读取失败时返回 false
+	 */
+	bool UpdateHashWithFileBytes(FArchive& FileReader, int64 Size, FXxHash64Builder& HashBuilder)
+	{
+		TArray<uint8> ReadBuffer;
+		ReadBuffer.SetNumUninitialized(FMath::Min(Size, ReadBufferSize));
+
+		while (Size > 0)
+		{
+			const int64 ReadSize = FMath::Min(Size, ReadBufferSize);
+			FileReader.Serialize(ReadBuffer.GetData(), ReadSize);
+			if (FileReader.IsError())
+			{
+				return false;
+			}
+
+			HashBuilder.Update(ReadBuffer.GetData(), ReadSize);
+			Size -= ReadSize;
+		}
+
+		return true;
+	}
+
+	/**
+	 * 规范化的名称表
+	 * SavePackage 按字符串对名称表排序，改名后的副本中资产名的位置会变，其后名称的下标随之移动
+	 * 包名和资产名替换为占位符后重新排序，CanonicalIndices 把保存时的下标映射到排序后的下标
+	 */
+	struct FNormalizedNameTable
+	{
+		TArray<FName> Names;
+		TArray<FString> NormalizedStrings;
+		TArray<int32> CanonicalIndices;
+	};
+
+	/**
+	 * 规范化一个导出的数据
+	 * 开头的标记属性流逐项读取，名称下标改写为规范化名称表中的下标，其余字节原样复制
+	 * 值本身是名称的属性、结构体和结构体数组会继续展开；原生序列化的部分无法定位名称，按原样计算哈希
+	 */
+	class FExportDataNormalizer
+	{
+	public:
+		FExportDataNormalizer(FArchive& InFileReader, const FNormalizedNameTable& InNameTable)
+			: FileReader(InFileReader)
+			, NameTable(InNameTable)
+		{
+		}
+
+		/**
+		 * @brief 规范化 [SerialOffset, SerialOffset + SerialSize) 中的导出数据，写入 Out
+		 * 标记属性流无法解析时整个导出按原样计算哈希
+		 * @param bParseTaggedProperties 包使用标记属性格式时才解析
+		 * @return 读取失败时返回 false
+		 */
+		bool NormalizeExport(int64 SerialOffset, int64 SerialSize, bool bParseTaggedProperties, TArray<uint8>& Out)
+		{
+			const int64 ExportEnd = SerialOffset + SerialSize;
+
+			FileReader.Seek(SerialOffset);
+			if (bParseTaggedProperties && !NormalizeTaggedProperties(ExportEnd, false, Out))
+			{
+				Out.Reset();
+				FileReader.Seek(SerialOffset);
+			}
+
+			// 标记属性流之后是类自己序列化的数据
+			return AppendRawHash(ExportEnd - FileReader.Tell(), Out);
+		}
+
+	private:
+		struct FTagHeader
+		{
+			FName Type;
+			int32 Size = 0;
+
+			/** 结构体名、枚举名或容器的元素类型 */
+			FName SubType;
+		};
+
+		/**
+		 * @brief 读取标记属性流，直到名称为 None 的结束标记
+		 * @param End 不能越过的位置
+		 * @param bMustReachEnd 结构体值的属性流必须恰好在 End 处结束
+		 */
+		bool NormalizeTaggedProperties(int64 End, bool bMustReachEnd, TArray<uint8>& Out)
+		{
+			for (;;)
+			{
+				FTagHeader Tag;
+				bool bIsEndTag = false;
+				if (!NormalizeTagHeader(End, Tag, bIsEndTag, Out))
+				{
+					return false;
+				}
+				if (bIsEndTag)
+				{
+					return !bMustReachEnd || FileReader.Tell() == End;
+				}
+
+				const int64 ValueEnd = FileReader.Tell() + Tag.Size;
+				if (ValueEnd > End || !NormalizeTagValue(Tag, ValueEnd, Out))
+				{
+					return false;
+				}
+			}
+		}
+
+		/** 与 FPropertyTag 的序列化顺序一致 */
+		bool NormalizeTagHeader(int64 End, FTagHeader& OutTag, bool& bOutIsEndTag, TArray<uint8>& Out)
+		{
+			FName TagName;
+			if (!NormalizeName(End, TagName, Out))
+			{
+				return false;
+			}
+
+			bOutIsEndTag = TagName.IsNone();
+			if (bOutIsEndTag)
+			{
+				return true;
+			}
+
+			int32 ArrayIndex = 0;
+			if (!NormalizeName(End, OutTag.Type, Out) || !CopyValue(End, OutTag.Size, Out) || !CopyValue(End, ArrayIndex, Out)
+				|| OutTag.Size < 0)
+			{
+				return false;
+			}
+
+			if (OutTag.Type.GetNumber() == 0)
+			{
+				if (OutTag.Type == NAME_StructProperty)
+				{
+					FGuid StructGuid;
+					if (!NormalizeName(End, OutTag.SubType, Out) || !CopyValue(End, StructGuid, Out))
+					{
+						return false;
+					}
+				}
+				else if (OutTag.Type == NAME_BoolProperty)
+				{
+					uint8 BoolValue = 0;
+					if (!CopyValue(End, BoolValue, Out))
+					{
+						return false;
+					}
+				}
+				else if (OutTag.Type == NAME_ByteProperty || OutTag.Type == NAME_EnumProperty
+					|| OutTag.Type == NAME_ArrayProperty || OutTag.Type == NAME_SetProperty)
+				{
+					if (!NormalizeName(End, OutTag.SubType, Out))
+					{
+						return false;
+					}
+				}
+				else if (OutTag.Type == NAME_MapProperty)
+				{
+					FName ValueType;
+					if (!NormalizeName(End, OutTag.SubType, Out) || !NormalizeName(End, ValueType, Out))
+					{
+						return false;
+					}
+				}
+			}
+
+			uint8 bHasPropertyGuid = 0;
+			if (!CopyValue(End, bHasPropertyGuid, Out))
+			{
+				return false;
+			}
+
+			FGuid PropertyGuid;
+			return !bHasPropertyGuid || CopyValue(End, PropertyGuid, Out);
+		}
+
+		bool NormalizeTagValue(const FTagHeader& Tag, int64 ValueEnd, TArray<uint8>& Out)
+		{
+			// 值本身是名称的属性
+			if (Tag.Size == sizeof(int32) * 2 && (Tag.Type == NAME_NameProperty || Tag.Type == NAME_EnumProperty
+				|| (Tag.Type == NAME_ByteProperty && !Tag.SubType.IsNone())))
+			{
+				FName ValueName;
+				return NormalizeName(ValueEnd, ValueName, Out);
+			}
+
+			// 结构体先尝试按标记属性流展开，原生序列化的结构体展开失败后按原样计算哈希
+			const int64 ValueStart = FileReader.Tell();
+			const int32 OutStart = Out.Num();
+
+			bool bNormalized = false;
+			if (Tag.Type == NAME_StructProperty)
+			{
+				bNormalized = NormalizeTaggedProperties(ValueEnd, true, Out);
+			}
+			else if (Tag.Type == NAME_ArrayProperty)
+			{
+				bNormalized = NormalizeArray(Tag.SubType, ValueEnd, Out);
+			}
+
+			if (!bNormalized)
+			{
+				Out.SetNum(OutStart, false);
+				FileReader.Seek(ValueStart);
+				return AppendRawHash(ValueEnd - ValueStart, Out);
+			}
+
+			return true;
+		}
+
+		/** 名称数组逐个改写；结构体数组先是元素的属性标记，再是每个元素的标记属性流 */
+		bool NormalizeArray(FName InnerType, int64 ValueEnd, TArray<uint8>& Out)
+		{
+			int32 NumElements = 0;
+			if (!CopyValue(ValueEnd, NumElements, Out) || NumElements < 0)
+			{
+				return false;
+			}
+			if (FileReader.Tell() == ValueEnd)
+			{
+				return NumElements == 0;
+			}
+
+			if (InnerType == NAME_NameProperty || InnerType == NAME_EnumProperty)
+			{
+				for (int32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+				{
+					FName ElementName;
+					if (!NormalizeName(ValueEnd, ElementName, Out))
+					{
+						return false;
+					}
+				}
+				return FileReader.Tell() == ValueEnd;
+			}
+
+			if (InnerType == NAME_StructProperty)
+			{
+				FTagHeader InnerTag;
+				bool bIsEndTag = false;
+				if (!NormalizeTagHeader(ValueEnd, InnerTag, bIsEndTag, Out) || bIsEndTag || InnerTag.Type != NAME_StructProperty)
+				{
+					return false;
+				}
+
+				for (int32 ElementIndex = 0; ElementIndex < NumElements; ++ElementIndex)
+				{
+					if (!NormalizeTaggedProperties(ValueEnd, false, Out))
+					{
+						return false;
+					}
+				}
+				return FileReader.Tell() == ValueEnd;
+			}
+
+			return false;
+		}
+
+		/** 读取 FName 的名称下标和编号，写入规范化名称表中的下标 */
+		bool NormalizeName(int64 End, FName& OutName, TArray<uint8>& Out)
+		{
+			int32 NameIndex = 0;
+			int32 Number = 0;
+			if (!ReadValue(End, NameIndex) || !ReadValue(End, Number) || !NameTable.Names.IsValidIndex(NameIndex))
+			{
+				return false;
+			}
+
+			OutName = FName(NameTable.Names[NameIndex], Number);
+			AppendValue(NameTable.CanonicalIndices[NameIndex], Out);
+			AppendValue(Number, Out);
+			return true;
+		}
+
+		/** 把 Size 个字节的长度和哈希写入 Out */
+		bool AppendRawHash(int64 Size, TArray<uint8>& Out)
+		{
+			FXxHash64Builder RawHashBuilder;
+			if (Size < 0 || !UpdateHashWithFileBytes(FileReader, Size, RawHashBuilder))
+			{
+				return false;
+			}
+
+			AppendValue(Size, Out);
+			AppendValue(RawHashBuilder.Finalize().Hash, Out);
+			return true;
+		}
+
+		template <typename ValueType>
+		bool ReadValue(int64 End, ValueType& OutValue)
+		{
+			if (FileReader.Tell() + static_cast<int64>(sizeof(ValueType)) > End)
+			{
+				return false;
+			}
+
+			FileReader.Serialize(&OutValue, sizeof(ValueType));
+			return !FileReader.IsError();
+		}
+
+		template <typename ValueType>
+		bool CopyValue(int64 End, ValueType& OutValue, TArray<uint8>& Out)
+		{
+			if (!ReadValue(End, OutValue))
+			{
+				return false;
+			}
+
+			AppendValue(OutValue, Out);
+			return true;
+		}
+
+		template <typename ValueType>
+		static void AppendValue(const ValueType& Value, TArray<uint8>& Out)
+		{
+			Out.Append(reinterpret_cast<const uint8*>(&Value), sizeof(ValueType));
+		}
+
+		FArchive& FileReader;
+		const FNormalizedNameTable& NameTable;
+	};
+
+	/**
+	 * @brief 读取名称表，包名和资产名替换为占位符后按字符串排序，把排序后的名称表加入哈希
+	 * @return 读取失败时返回 false
+	 */
+	bool HashNameTable(FArchive& FileReader, const FPackageFileSummary& PackageSummary, FName PackageName,
+		FNormalizedNameTable& OutNameTable, FXxHash64Builder& HashBuilder)
+	{
+		const FString PackageNameString = PackageName.ToString();
+		const FString AssetNameString = FPackageName::GetShortName(PackageNameString);
+
+		OutNameTable.Names.Reserve(PackageSummary.NameCount);
+		OutNameTable.NormalizedStrings.Reserve(PackageSummary.NameCount);
+
+		FileReader.Seek(PackageSummary.NameOffset);
+		for (int32 NameIndex = 0; NameIndex < PackageSummary.NameCount; ++NameIndex)
+		{
+			FNameEntrySerialized NameEntry(ENAME_LinkerConstructor);
+			FileReader << NameEntry;
+			if (FileReader.IsError())
+			{
+				return false;
+			}
+
+			const FName Name(NameEntry);
+			OutNameTable.Names.Add(Name);
+
+			FString NameString = Name.ToString();
+			if (NameString.Equals(PackageNameString, ESearchCase::IgnoreCase))
+			{
+				NameString = TEXT("<Package>");
+			}
+			else if (NameString.Equals(AssetNameString, ESearchCase::IgnoreCase))
+			{
+				NameString = TEXT("<Asset>");
+			}
+			OutNameTable.NormalizedStrings.Add(MoveTemp(NameString));
+		}
+
+		TArray<int32> SortedNameIndices;
+		SortedNameIndices.Reserve(PackageSummary.NameCount);
+		for (int32 NameIndex = 0; NameIndex < PackageSummary.NameCount; ++NameIndex)
+		{
+			SortedNameIndices.Add(NameIndex);
+		}
+
+		const TArray<FString>& NormalizedStrings = OutNameTable.NormalizedStrings;
+		SortedNameIndices.Sort([&NormalizedStrings](int32 IndexA, int32 IndexB)
+		{
+			const int32 Comparison = NormalizedStrings[IndexA].Compare(NormalizedStrings[IndexB], ESearchCase::CaseSensitive);
+			return Comparison != 0 ? Comparison < 0 : IndexA < IndexB;
+		});
+
+		OutNameTable.CanonicalIndices.SetNum(PackageSummary.NameCount);
+		for (int32 SortedIndex = 0; SortedIndex < SortedNameIndices.Num(); ++SortedIndex)
+		{
+			OutNameTable.CanonicalIndices[SortedNameIndices[SortedIndex]] = SortedIndex;
+			UpdateHashWithString(HashBuilder, NormalizedStrings[SortedNameIndices[SortedIndex]]);
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief 把导入表加入哈希，按类所在的包、类名、对象名和外部对象下标逐项加入
+	 * 导入表按被导入对象的路径排序，与本包的名称无关
+	 * @return 读取失败时返回 false
+	 */
+	bool HashImportTable(FArchive& FileReader, const FPackageFileSummary& PackageSummary, const FNormalizedNameTable& NameTable,
+		FXxHash64Builder& HashBuilder)
+	{
+		FileReader.Seek(PackageSummary.ImportOffset);
+		FPackageNameMapReader ImportReader(FileReader, NameTable.Names);
+		for (int32 ImportIndex = 0; ImportIndex < PackageSummary.ImportCount; ++ImportIndex)
+		{
+			FObjectImport Import;
+			ImportReader << Import;
+			if (ImportReader.IsError() || FileReader.IsError())
+			{
+				return false;
+			}
+
+			UpdateHashWithString(HashBuilder, Import.ClassPackage.ToString());
+			UpdateHashWithString(HashBuilder, Import.ClassName.ToString());
+			UpdateHashWithString(HashBuilder, Import.ObjectName.ToString());
+
+			const int32 OuterIndex = Import.OuterIndex.ForDebugging();
+			HashBuilder.Update(&OuterIndex, sizeof(OuterIndex));
+		}
+
+		return true;
+	}
+
+	/**
+	 * @brief 按导出表逐个规范化导出数据并加入哈希
+	 * 导出的类、父类、模板和外部对象都是对象表下标，与名称无关；对象名与资产名相同时替换为占位符
+	 * @param OutExportsEnd 导出数据的结束位置
+	 * @return 读取失败或导出表无效时返回 false
+	 */
+	bool HashExports(FArchive& FileReader, const FPackageFileSummary& PackageSummary, FName PackageName,
+		const FNormalizedNameTable& NameTable, FXxHash64Builder& HashBuilder, int64& OutExportsEnd)
+	{
+		TArray<FObjectExport> Exports;
+		Exports.Reserve(PackageSummary.ExportCount);
+
+		FileReader.Seek(PackageSummary.ExportOffset);
+		FPackageNameMapReader ExportReader(FileReader, NameTable.Names);
+		for (int32 ExportIndex = 0; ExportIndex < PackageSummary.ExportCount; ++ExportIndex)
+		{
+			ExportReader << Exports.AddDefaulted_GetRef();
+			if (ExportReader.IsError() || FileReader.IsError())
+			{
+				return false;
+			}
+		}
+
+		// 未版本化的属性不带标记，无法定位其中的名称
+		const bool bParseTaggedProperties = (PackageSummary.GetPackageFlags() & PKG_UnversionedProperties) == 0
+			&& PackageSummary.GetFileVersionUE() >= VER_UE4_PROPERTY_TAG_SET_MAP_SUPPORT
+			&& PackageSummary.GetFileVersionUE() >= VER_UE4_PROPERTY_GUID_IN_PROPERTY_TAG;
+
+		const FString AssetNameString = FPackageName::GetShortName(PackageName);
+		const int64 FileSize = FileReader.TotalSize();
+
+		FExportDataNormalizer Normalizer(FileReader, NameTable);
+		TArray<uint8> NormalizedData;
+
+		for (const FObjectExport& Export : Exports)
+		{
+			if (Export.SerialOffset < PackageSummary.TotalHeaderSize || Export.SerialSize < 0
+				|| Export.SerialOffset + Export.SerialSize > FileSize)
+			{
+				return false;
+			}
+
+			const FString ObjectNameString = Export.ObjectName.ToString();
+			UpdateHashWithString(HashBuilder, ObjectNameString.Equals(AssetNameString, ESearchCase::IgnoreCase) ? TEXT("<Asset>") : *ObjectNameString);
+
+			const int32 ObjectIndices[] = { Export.ClassIndex.ForDebugging(), Export.SuperIndex.ForDebugging(),
+				Export.TemplateIndex.ForDebugging(), Export.OuterIndex.ForDebugging() };
+			HashBuilder.Update(ObjectIndices, sizeof(ObjectIndices));
+
+			const uint32 ObjectFlags = static_cast<uint32>(Export.ObjectFlags);
+			HashBuilder.Update(&ObjectFlags, sizeof(ObjectFlags));
+
+			NormalizedData.Reset();
+			if (!Normalizer.NormalizeExport(Export.SerialOffset, Export.SerialSize, bParseTaggedProperties, NormalizedData))
+			{
+				return false;
+			}
+			HashBuilder.Update(NormalizedData.GetData(), NormalizedData.Num());
+
+			OutExportsEnd = FMath::Max(OutExportsEnd, Export.SerialOffset + Export.SerialSize);
+		}
+
+		return true;
+	}
+}
+
+FPackageContentHashCache::~FPackageContentHashCache()
+{
+	CancelAndWait();
+}
+
+/**
+ * @brief 计算每个包的内容比较键
+ * 第一遍读取所有包的包头得到内容长度，第二遍只对长度与其它包相同的包流式计算哈希
+ * @param PackageNames 包名
+ * @param OutContentKeys 与 PackageNames 一一对应，长度唯一或无法读取的包返回无效的键
+ * @param bCancelRequested 可选的取消标记，取消后尽快返回，已读取的包仍写入缓存，返回的键不完整
+ */
+void FPackageContentHashCache::ComputeContentKeys(const TArray<FName>& PackageNames, TArray<FPackageContentKey>& OutContentKeys,
+	const std::atomic<bool>* bCancelRequested)
+{
+	auto IsCancelRequested = [bCancelRequested]()
+	{
+		return bCancelRequested && bCancelRequested->load();
+	};
+
+	const int32 NumPackages = PackageNames.Num();
+
+	OutContentKeys.Reset();
+	OutContentKeys.SetNum(NumPackages);
+
+	TArray<FString> Filenames;
+	Filenames.SetNum(NumPackages);
+
+	TArray<FCachedPackageContent> PackageContents;
+	PackageContents.SetNum(NumPackages);
+
+	// 第一遍：文件大小和修改时间没变时直接使用缓存，否则重新读取包头
+	ParallelFor(NumPackages, [&](int32 PackageIndex)
+	{
+		if (IsCancelRequested())
+		{
+			return;
+		}
+
+		FFileStatData StatData;
+		if (!ResolvePackageFilename(PackageNames[PackageIndex], Filenames[PackageIndex], StatData))
+		{
+			return;
+		}
+
+		FCachedPackageContent& PackageContent = PackageContents[PackageIndex];
+		{
+			FScopeLock ScopeLock(&CacheLock);
+			if (const FCachedPackageContent* CachedContent = CachedPackages.Find(PackageNames[PackageIndex]))
+			{
+				if (CachedContent->FileSize == StatData.FileSize && CachedContent->ModificationTime == StatData.ModificationTime)
+				{
+					PackageContent = *CachedContent;
+					return;
+				}
+			}
+		}
+
+		PackageContent.FileSize = StatData.FileSize;
+		PackageContent.ModificationTime = StatData.ModificationTime;
+		PackageContent.PayloadOffset = ReadPayloadOffset(Filenames[PackageIndex], StatData.FileSize);
+
+		FScopeLock ScopeLock(&CacheLock);
+		CachedPackages.Add(PackageNames[PackageIndex], PackageContent);
+	}, EParallelForFlags::Unbalanced);
+
+	if (IsCancelRequested())
+	{
+		return;
+	}
+
+	// 内容长度唯一的包不可能与其它包相同，不需要读取
+	TMap<int64, int32> NumPackagesByPayloadSize;
+	for (const FCachedPackageContent& PackageContent : PackageContents)
+	{
+		if (PackageContent.PayloadOffset != INDEX_NONE)
+		{
+			++NumPackagesByPayloadSize.FindOrAdd(PackageContent.FileSize - PackageContent.PayloadOffset);
+		}
+	}
+
+	TArray<int32> PackageIndicesToHash;
+	for (int32 PackageIndex = 0; PackageIndex < NumPackages; ++PackageIndex)
+	{
+		const FCachedPackageContent& PackageContent = PackageContents[PackageIndex];
+		if (PackageContent.PayloadOffset != INDEX_NONE && !PackageContent.bHasPayloadHash
+			&& NumPackagesByPayloadSize.FindRef(PackageContent.FileSize - PackageContent.PayloadOffset) > 1)
+		{
+			PackageIndicesToHash.Add(PackageIndex);
+		}
+	}
+
+	// 第二遍：流式计算哈希并写回缓存
+	ParallelFor(PackageIndicesToHash.Num(), [&](int32 HashIndex)
+	{
+		if (IsCancelRequested())
+		{
+			return;
+		}
+
+		const int32 PackageIndex = PackageIndicesToHash[HashIndex];
+		FCachedPackageContent& PackageContent = PackageContents[PackageIndex];
+
+		if (!HashPackageContent(Filenames[PackageIndex], PackageNames[PackageIndex], PackageContent.PayloadOffset, PackageContent.PayloadHash))
+		{
+			return;
+		}
+		PackageContent.bHasPayloadHash = true;
+
+		FScopeLock ScopeLock(&CacheLock);
+		CachedPackages.Add(PackageNames[PackageIndex], PackageContent);
+	}, EParallelForFlags::Unbalanced);
+
+	for (int32 PackageIndex = 0; PackageIndex < NumPackages; ++PackageIndex)
+	{
+		const FCachedPackageContent& PackageContent = PackageContents[PackageIndex];
+		if (PackageContent.bHasPayloadHash
+			&& NumPackagesByPayloadSize.FindRef(PackageContent.FileSize - PackageContent.PayloadOffset) > 1)
+		{
+			FPackageContentKey& ContentKey = OutContentKeys[PackageIndex];
+			ContentKey.PayloadSize = PackageContent.FileSize - PackageContent.PayloadOffset;
+			ContentKey.PayloadHash = PackageContent.PayloadHash;
+			ContentKey.bHasPayloadHash = true;
+		}
+	}
+}
+
+/**
+ * @brief 在线程池中计算内容比较键，不阻塞游戏线程
+ * 上一次计算尚未结束时只标记取消，不等待它结束，被取消的计算不会调用 OnCompleted
+ * 缓存的读写都加锁，短时间内同时存在的多个计算可以共用缓存
+ * @param PackageNames 包名
+ * @param OnCompleted 在游戏线程调用，键与 PackageNames 一一对应
+ */
+void FPackageContentHashCache::ComputeContentKeysAsync(TArray<FName>&& PackageNames,
+	TFunction<void(TArray<FPackageContentKey>&& ContentKeys)>&& OnCompleted)
+{
+	if (RunningCancelFlag.IsValid())
+	{
+		*RunningCancelFlag = true;
+	}
+	ComputeFutures.RemoveAll([](const TFuture<void>& ComputeFuture)
+	{
+		return ComputeFuture.IsReady();
+	});
+
+	TSharedRef<std::atomic<bool>> bCancelRequested = MakeShared<std::atomic<bool>>(false);
+	RunningCancelFlag = bCancelRequested;
+
+	ComputeFutures.Add(Async(EAsyncExecution::ThreadPool,
+		[this, bCancelRequested, PackageNames = MoveTemp(PackageNames), OnCompleted = MoveTemp(OnCompleted)]() mutable
+		{
+			TArray<FPackageContentKey> ContentKeys;
+			ComputeContentKeys(PackageNames, ContentKeys, &bCancelRequested.Get());
+			if (*bCancelRequested)
+			{
+				return;
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [ContentKeys = MoveTemp(ContentKeys), OnCompleted = MoveTemp(OnCompleted)]() mutable
+			{
+				OnCompleted(MoveTemp(ContentKeys));
+			});
+		}));
+}
+
+/**
+ * @brief 取消所有后台计算并等待它们结束，模块卸载时使用
+ */
+void FPackageContentHashCache::CancelAndWait()
+{
+	if (RunningCancelFlag.IsValid())
+	{
+		*RunningCancelFlag = true;
+		RunningCancelFlag.Reset();
+	}
+
+	for (TFuture<void>& ComputeFuture : ComputeFutures)
+	{
+		ComputeFuture.Wait();
+	}
+	ComputeFutures.Reset();
+}
+
+void FPackageContentHashCache::Reset()
+{
+	CancelAndWait();
+
+	FScopeLock ScopeLock(&CacheLock);
+	CachedPackages.Empty();
+}
+
+/**
+ * @brief 由包名得到磁盘上的文件名，资产包和关卡包的扩展名不同，依次尝试
+ * @return 文件存在时返回 true
+ */
+bool FPackageContentHashCache::ResolvePackageFilename(FName PackageName, FString& OutFilename, FFileStatData& OutStatData)
+{
+	const FString PackageNameString = PackageName.ToString();
+
+	for (const FString& Extension : { FPackageName::GetAssetPackageExtension(), FPackageName::GetMapPackageExtension() })
+	{
+		if (!FPackageName::TryConvertLongPackageNameToFilename(PackageNameString, OutFilename, Extension))
+		{
+			return false;
+		}
+
+		OutStatData = IFileManager::Get().GetStatData(*OutFilename);
+		if (OutStatData.bIsValid && !OutStatData.bIsDirectory)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief 读取包文件摘要，得到包头之后内容的起始位置
+ * @return 起始位置，不是有效的包文件时返回 INDEX_NONE
+ */
+int64 FPackageContentHashCache::ReadPayloadOffset(const FString& Filename, int64 FileSize)
+{
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!FileReader)
+	{
+		return INDEX_NONE;
+	}
+
+	FPackageFileSummary PackageSummary;
+	*FileReader << PackageSummary;
+
+	if (FileReader->IsError() || PackageSummary.Tag != PACKAGE_FILE_TAG
+		|| PackageSummary.TotalHeaderSize <= 0 || PackageSummary.TotalHeaderSize > FileSize)
+	{
+		return INDEX_NONE;
+	}
+
+	return PackageSummary.TotalHeaderSize;
+}
+
+/**
+ * @brief 计算规范化后的名称表、导入表、导出数据，以及导出数据之后内容的 XXH64
+ * 导出数据只保存名称和导入的下标，只比较包头之后的字节会把引用不同资产的包（如使用不同纹理的材质实例）判为相同
+ * 名称表按规范化后的字符串排序，导出数据中的名称下标改写为排序后的下标，结果与资产名的排序位置无关
+ * @return 读取成功时返回 true
+ */
+bool FPackageContentHashCache::HashPackageContent(const FString& Filename, FName PackageName, int64 PayloadOffset, uint64& OutPayloadHash)
+{
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*Filename));
+	if (!FileReader)
+	{
+		return false;
+	}
+
+	FPackageFileSummary PackageSummary;
+	*FileReader << PackageSummary;
+	if (FileReader->IsError() || PackageSummary.Tag != PACKAGE_FILE_TAG
+		|| PackageSummary.NameCount < 0 || PackageSummary.ImportCount < 0 || PackageSummary.ExportCount < 0)
+	{
+		return false;
+	}
+
+	FileReader->SetUEVer(PackageSummary.GetFileVersionUE());
+	FileReader->SetLicenseeUEVer(PackageSummary.GetFileVersionLicenseeUE());
+	FileReader->SetCustomVersions(PackageSummary.GetCustomVersionContainer());
+	FileReader->SetFilterEditorOnly((PackageSummary.GetPackageFlags() & PKG_FilterEditorOnly) != 0);
+
+	FXxHash64Builder HashBuilder;
+	FNormalizedNameTable NameTable;
+	int64 ExportsEnd = PayloadOffset;
+	if (!HashNameTable(*FileReader, PackageSummary, PackageName, NameTable, HashBuilder)
+		|| !HashImportTable(*FileReader, PackageSummary, NameTable, HashBuilder)
+		|| !HashExports(*FileReader, PackageSummary, PackageName, NameTable, HashBuilder, ExportsEnd))
+	{
+		return false;
+	}
+
+	// 导出数据之后是 BulkData 和包尾，其中没有名称下标，按原样加入
+	const int64 TrailingOffset = FMath::Max(ExportsEnd, PayloadOffset);
+	FileReader->Seek(TrailingOffset);
+	if (!UpdateHashWithFileBytes(*FileReader, FileReader->TotalSize() - TrailingOffset, HashBuilder))
+	{
+		return false;
+	}
+
+	OutPayloadHash = HashBuilder.Finalize().Hash;
+	return true;
+}
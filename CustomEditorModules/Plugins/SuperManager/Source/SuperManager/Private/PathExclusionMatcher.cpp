@@ -0,0 +1,163 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PathExclusionMatcher.h"
+#include "AssetRegistry/AssetData.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/PathViews.h"
+
+namespace
+{
+	/**
+	 * @brief 按 '/' 切分路径并逐级回调，空的层级会被跳过
+	 * @return 回调返回 true 时提前结束并返回 true
+	 */
+	template <typename FuncType>
+	bool ForEachPathSegment(FStringView Path, FuncType&& Func)
+	{
+		while (Path.Len() > 0)
+		{
+			int32 SeparatorIndex = INDEX_NONE;
+			const FStringView Segment = Path.FindChar(TEXT('/'), SeparatorIndex) ? Path.Left(SeparatorIndex) : Path;
+			Path.RightChopInline(Segment.Len() + 1);
+
+			if (Segment.Len() > 0 && Func(Segment))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+/**
+ * @brief 从插件 Config/DefaultSuperManager.ini 的 [PathExclusion] 读取规则并编译
+ * @param AdditionalFolderNames 追加的文件夹名规则，例如命令行参数
+ * @param AdditionalPathPrefixes 追加的路径前缀规则
+ */
+void FPathExclusionMatcher::LoadFromPluginConfig(const TArray<FString>& AdditionalFolderNames, const TArray<FString>& AdditionalPathPrefixes)
+{
+	TArray<FString> FolderNames = AdditionalFolderNames;
+	TArray<FString> PathPrefixes = AdditionalPathPrefixes;
+
+	const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("SuperManager"));
+	if (Plugin.IsValid())
+	{
+		FConfigFile ConfigFile;
+		ConfigFile.Read(Plugin->GetBaseDir() / TEXT("Config/DefaultSuperManager.ini"));
+
+		TArray<FString> ConfigFolderNames;
+		TArray<FString> ConfigPathPrefixes;
+		ConfigFile.GetArray(TEXT("PathExclusion"), TEXT("ExcludedFolderNames"), ConfigFolderNames);
+		ConfigFile.GetArray(TEXT("PathExclusion"), TEXT("ExcludedPathPrefixes"), ConfigPathPrefixes);
+
+		FolderNames.Append(ConfigFolderNames);
+		PathPrefixes.Append(ConfigPathPrefixes);
+	}
+
+	Compile(FolderNames, PathPrefixes);
+}
+
+/**
+ * @brief 把规则编译成文件夹名集合和前缀树
+ * @param InExcludedFolderNames 任意一级同名即排除的文件夹名
+ * @param InExcludedPathPrefixes 需要排除的路径前缀，如 /Game/ThirdParty
+ */
+void FPathExclusionMatcher::Compile(const TArray<FString>& InExcludedFolderNames, const TArray<FString>& InExcludedPathPrefixes)
+{
+	ExcludedFolderNames.Reset();
+	PrefixTrieNodes.Reset();
+	PrefixTrieNodes.AddDefaulted();
+
+	for (const FString& FolderName : InExcludedFolderNames)
+	{
+		if (!FolderName.IsEmpty())
+		{
+			ExcludedFolderNames.Add(FName(*FolderName));
+		}
+	}
+
+	for (const FString& PathPrefix : InExcludedPathPrefixes)
+	{
+		int32 NodeIndex = 0;
+		ForEachPathSegment(PathPrefix, [this, &NodeIndex](FStringView Segment)
+		{
+			const FName SegmentName(Segment.Len(), Segment.GetData());
+			if (const int32* ChildIndex = PrefixTrieNodes[NodeIndex].Children.Find(SegmentName))
+			{
+				NodeIndex = *ChildIndex;
+			}
+			else
+			{
+				const int32 NewNodeIndex = PrefixTrieNodes.AddDefaulted();
+				PrefixTrieNodes[NodeIndex].Children.Add(SegmentName, NewNodeIndex);
+				NodeIndex = NewNodeIndex;
+			}
+			return false;
+		});
+
+		// 空前缀不生效，否则会排除所有路径
+		if (NodeIndex != 0)
+		{
+			PrefixTrieNodes[NodeIndex].bExcluded = true;
+		}
+	}
+}
+
+/**
+ * @brief 检查文件夹路径是否被排除
+ * @param FolderPath 文件夹路径，如 /Game/Developers/Someone
+ * @return 
+ */
+bool FPathExclusionMatcher::IsFolderExcluded(FStringView FolderPath) const
+{
+	int32 NodeIndex = PrefixTrieNodes.Num() > 0 ? 0 : INDEX_NONE;
+
+	return ForEachPathSegment(FolderPath, [this, &NodeIndex](FStringView Segment)
+	{
+		// 规则里的名字一定已经在 FName 表中，查不到说明这一级不可能命中任何规则
+		const FName SegmentName = FindSegmentName(Segment);
+		if (SegmentName.IsNone())
+		{
+			NodeIndex = INDEX_NONE;
+			return false;
+		}
+
+		if (ExcludedFolderNames.Contains(SegmentName))
+		{
+			return true;
+		}
+
+		if (NodeIndex != INDEX_NONE)
+		{
+			const int32* ChildIndex = PrefixTrieNodes[NodeIndex].Children.Find(SegmentName);
+			NodeIndex = ChildIndex ? *ChildIndex : INDEX_NONE;
+			if (NodeIndex != INDEX_NONE && PrefixTrieNodes[NodeIndex].bExcluded)
+			{
+				return true;
+			}
+		}
+		return false;
+	});
+}
+
+bool FPathExclusionMatcher::IsFolderExcluded(FName FolderPath) const
+{
+	const FNameBuilder FolderPathBuilder(FolderPath);
+	return IsFolderExcluded(FolderPathBuilder.ToView());
+}
+
+/**
+ * @brief 按资产所在的文件夹检查是否被排除，资产名本身不参与匹配
+ * @param AssetData 资产数据
+ * @return 
+ */
+bool FPathExclusionMatcher::IsAssetExcluded(const FAssetData& AssetData) const
+{
+	return IsFolderExcluded(AssetData.PackagePath);
+}
+
+FName FPathExclusionMatcher::FindSegmentName(FStringView Segment)
+{
+	return FName(Segment.Len(), Segment.GetData(), FNAME_Find);
+}
@@ -3,11 +3,11 @@
 
 #include "QuickAssetAction.h"
 #include "DebugHeader.h"
+#include "SuperManager.h"
 #include "EditorUtilityLibrary.h"
 #include "EditorAssetLibrary.h"
 #include "Misc/MessageDialog.h"
 
-#include "ObjectTools.h" // 使用 ObjectTools 中的删除方法，而不是使用 UEditorAssetLibrary 中的强制删除。
 
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/ARFilter.h"
@@ -91,16 +91,36 @@ void UQuickAssetAction::AddPrefixes()
 void UQuickAssetAction::RemoveUnusedAssets()
 {
 	TArray<FAssetData> SelectedAssetsData = UEditorUtilityLibrary::GetSelectedAssetData();
+
+	// 只修复与所选资产所在目录相关的重定向器，修复完成后再检查引用
+	TArray<FString> SelectedPackagePaths;
+	for (const FAssetData& Data : SelectedAssetsData)
+	{
+		SelectedPackagePaths.AddUnique(Data.PackagePath.ToString());
+	}
+
+	FSuperManagerModule& SuperManagerModule =
+	FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
+
+	SuperManagerModule.GetRedirectorFixup().FixUpRedirectorsInPaths(SelectedPackagePaths,
+		FRedirectorFixup::FOnFixupCompleted::CreateLambda([SelectedAssetsData]()
+		{
+			RemoveUnusedAssetsAmong(SelectedAssetsData);
+		}));
+}
+
+void UQuickAssetAction::RemoveUnusedAssetsAmong(const TArray<FAssetData>& SelectedAssetsData)
+{
 	TArray<FAssetData> UnusedAssetsData;
 
-	FixUpRedirectors();
+	FSuperManagerModule& SuperManagerModule =
+	FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
+	const FAssetReferenceIndex& ReferenceIndex = SuperManagerModule.GetUpToDateAssetReferenceIndex();
 
 	for (const FAssetData& Data : SelectedAssetsData)
 	{
-		TArray<FString> AssetReferencers =
-		UEditorAssetLibrary::FindPackageReferencersForAsset(Data.GetSoftObjectPath().ToString());
-
-		if (AssetReferencers.Num() == 0)
+		// 修复过程中被删除的重定向器不再检查；尚未保存、不在索引中的资产向注册表查询
+		if (!Data.IsRedirector() && ReferenceIndex.IsPackageUnused(Data.PackageName))
 		{
 			UnusedAssetsData.Add(Data);
 		}
@@ -112,46 +132,14 @@ void UQuickAssetAction::RemoveUnusedAssets()
 		return;
 	}
 
-	const int32 NumOfAssetsDeleted = ObjectTools::DeleteAssets(UnusedAssetsData, true);
+	FAssetDeletionOptions DeletionOptions;
+	DeletionOptions.bOnlyUnreferenced = true;
+
+	const TArray<EAssetDeletionResult> DeletionResults =
+		FAssetDeletionService::DeleteAssets(UnusedAssetsData, ReferenceIndex, DeletionOptions);
+	const int32 NumOfAssetsDeleted = FAssetDeletionService::CountResults(DeletionResults, EAssetDeletionResult::Deleted);
 
 	if (NumOfAssetsDeleted == 0) return; // 取消了删除操作
 
 	Debug::ShowNotifyInfo(TEXT("Successfully deleted ") + FString::FromInt(NumOfAssetsDeleted) + TEXT(" unused assets"));
 }
-
-void UQuickAssetAction::FixUpRedirectors()
-{
-	TArray<UObjectRedirector*> RedirectorsToFixArray;
-
-	// 通过 FModuleManager 类加载模块，LoadModuleChecked 方法保证了模块不会被重复加载
-	// 使用 AssetRegistryModule 的 GetAssets() 方法来获取所有需要重定向的资产数据
-	FAssetRegistryModule& AssetRegistryModule =
-	FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
-
-	// 创建 GetAssets() 所需的筛选器
-	FARFilter Filter;
-	Filter.bRecursivePaths = true;					// 递归子文件夹
-	Filter.bRecursiveClasses = true;				// 包括派生类
-	Filter.PackagePaths.Add("/Game");
-	Filter.ClassPaths.Add(UObjectRedirector::StaticClass()->GetClassPathName());
-
-	// 需要重定向的资产数据
-	TArray<FAssetData> OutRedirectors;
-	AssetRegistryModule.Get().GetAssets(Filter, OutRedirectors, false);
-
-	// FAssetData.GetAsset() 得到 UObject*, 将其转换成 UObjectRedirector*
-	for (const FAssetData& RedirectorData : OutRedirectors)
-	{
-		if (UObjectRedirector* RedirectorToFix = Cast<UObjectRedirector>(RedirectorData.GetAsset()))
-		{
-			RedirectorsToFixArray.Add(RedirectorToFix);
-		}
-	}
-
-	// 使用 AssetToolsModule 中的 FixupReferencers() 方法来修复重定向器
-	FAssetToolsModule& AssetToolsModule =
-	FModuleManager::Get().LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
-
-	AssetToolsModule.Get().FixupReferencers(RedirectorsToFixArray);
-}
-
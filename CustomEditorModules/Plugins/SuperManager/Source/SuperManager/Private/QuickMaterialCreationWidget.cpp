@@ -4,11 +4,19 @@
 #include "QuickMaterialCreationWidget.h"
 #include "AssetToolsModule.h"
 #include "DebugHeader.h"
+#include "TextureSuffixMatcher.h"
 #include "EditorAssetLibrary.h"
 #include "EditorUtilityLibrary.h"
 #include "Factories/MaterialFactoryNew.h"
 #include "Factories/MaterialInstanceConstantFactoryNew.h"
 #include "Materials/MaterialInstanceConstant.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "FileHelpers.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopedSlowTask.h"
+#include "ShaderCompiler.h"
 
 #pragma region QuickMaterialCreationCore
 
@@ -27,13 +35,22 @@ void UQuickMaterialCreationWidget::CreateMaterialFromSelectedTextures()
 		}
 	}
 	
+	EnsureTextureSuffixMatcherUpToDate();
+
 	const TArray<FAssetData> SelectedAssetData = UEditorUtilityLibrary::GetSelectedAssetData();
-	TArray<UTexture2D*> SelectedTexturesArray;
+	TArray<FAssetData> SelectedTexturesData;
 	FString SelectedTextureFolderPath;
 	uint32 PinsConnectedCounter = 0;
 
-	if (!ProcessSelectedData(SelectedAssetData, SelectedTexturesArray, SelectedTextureFolderPath))
+	if (!ProcessSelectedData(SelectedAssetData, SelectedTexturesData, SelectedTextureFolderPath))
+	{
+		MaterialName = TEXT("M_");
+		return;
+	}
+
+	if (bUseMasterMaterial)
 	{
+		CreateMasterMaterialInstance(SelectedTexturesData, SelectedTextureFolderPath);
 		MaterialName = TEXT("M_");
 		return;
 	}
@@ -51,35 +68,465 @@ void UQuickMaterialCreationWidget::CreateMaterialFromSelectedTextures()
 		return;
 	}
 
-	for (UTexture2D* Texture : SelectedTexturesArray)
+	TArray<UTexture2D*> SelectedTexturesArray;
+	LoadTexturesToBind(SelectedTexturesData, SelectedTexturesArray);
+	ConnectTexturesToMaterial(CreatedMaterial, SelectedTexturesArray, PinsConnectedCounter);
+
+	if (PinsConnectedCounter > 0)
 	{
-		if (!Texture) continue;
+		Debug::ShowNotifyInfo(TEXT("Successfully connected ") + FString::FromInt(PinsConnectedCounter) + TEXT(" pins"));
+	}
+	
+	if (bCreateMaterialInstance)
+	{
+		if (UMaterialInstanceConstant* CreatedMI = CreateMaterialInstanceAsset(CreatedMaterial, MaterialName, SelectedTextureFolderPath))
+		{
+			CreatedMI->PostEditChange();
+		}
+	}
 
-		switch (ChannelPackingType)
+	MaterialName = TEXT("M_");
+}
+
+#pragma endregion
+
+
+#pragma region BatchMaterialCreation
+
+/**
+ * @brief 批量创建材质：把纹理按套分组，每套创建一个材质（和材质实例）
+ * 所有资产创建完成后一次保存，再把保存的文件一次交给注册表扫描，不为每个资产单独通知
+ * 材质的着色器编译交给 ShaderCompileWorker 在后台进行，不等待编译完成
+ */
+void UQuickMaterialCreationWidget::CreateMaterialsFromTextureSets()
+{
+	EnsureTextureSuffixMatcherUpToDate();
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TArray<FAssetData> TexturesData;
+	if (bUseTextureFolder)
+	{
+		FARFilter Filter;
+		Filter.PackagePaths.Add(FName(*TextureFolderPath));
+		Filter.bRecursivePaths = true;
+		Filter.ClassPaths.Add(UTexture2D::StaticClass()->GetClassPathName());
+		Filter.bRecursiveClasses = true;
+		AssetRegistry.GetAssets(Filter, TexturesData);
+	}
+	else
+	{
+		TexturesData = UEditorUtilityLibrary::GetSelectedAssetData();
+		TexturesData.RemoveAll([](const FAssetData& AssetData)
 		{
-		case E_ChannelPackingType::ECPT_NoChannelPacking:
-			Default_CreateMaterialNodes(CreatedMaterial, Texture, PinsConnectedCounter);
-			break;
-		case E_ChannelPackingType::ECPT_ORM:
-			ORM_CreateMaterialNodes(CreatedMaterial, Texture, PinsConnectedCounter);
-			break;
-		case E_ChannelPackingType::ECPT_MAX: break;
-		default: ;
+			return !AssetData.IsInstanceOf(UTexture2D::StaticClass());
+		});
+	}
+
+	if (TexturesData.Num() == 0)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No texture found"));
+		return;
+	}
+
+	if (bUseMasterMaterial && !GetMasterMaterial())
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No master material set for the current channel packing type"));
+		return;
+	}
+
+	TArray<FMaterialTextureSet> TextureSets;
+	GatherTextureSets(TexturesData, TextureSets);
+
+	TArray<UPackage*> CreatedPackages;
+	TSet<FString> CreatedObjectPaths;
+	int32 NumSkippedSets = 0;
+
+	{
+		FScopedSlowTask SlowTask(TextureSets.Num(), FText::FromString(TEXT("Creating materials...")));
+		SlowTask.MakeDialog(true);
+
+		for (const FMaterialTextureSet& TextureSet : TextureSets)
+		{
+			if (SlowTask.ShouldCancel())
+			{
+				break;
+			}
+			SlowTask.EnterProgressFrame(1.f, FText::FromString(TextureSet.BaseName));
+
+			if (!CreateMaterialForTextureSet(TextureSet, CreatedPackages, CreatedObjectPaths))
+			{
+				++NumSkippedSets;
+			}
 		}
-		
 	}
 
-	if (PinsConnectedCounter > 0)
+	// 保存失败或被取消的包仍是脏的，留在内存中由用户稍后保存
+	int32 NumUnsavedPackages = 0;
+	if (CreatedPackages.Num() > 0)
 	{
-		Debug::ShowNotifyInfo(TEXT("Successfully connected ") + FString::FromInt(PinsConnectedCounter) + TEXT(" pins"));
+		TArray<UPackage*> FailedPackages;
+		if (FEditorFileUtils::PromptForCheckoutAndSave(CreatedPackages, false, false, &FailedPackages) == ECommandResult::Cancelled)
+		{
+			Debug::PrintLog(TEXT("Saving created materials was cancelled"));
+		}
+
+		TArray<FString> SavedPackageFilenames;
+		for (const UPackage* CreatedPackage : CreatedPackages)
+		{
+			if (CreatedPackage->IsDirty() || FailedPackages.Contains(CreatedPackage))
+			{
+				// 未保存的包扫描不到，单独登记到注册表，让它们出现在内容浏览器中
+				++NumUnsavedPackages;
+				Debug::PrintLog(CreatedPackage->GetName() + TEXT(" failed to save"));
+				if (UObject* UnsavedAsset = CreatedPackage->FindAssetInPackage())
+				{
+					FAssetRegistryModule::AssetCreated(UnsavedAsset);
+				}
+				continue;
+			}
+
+			SavedPackageFilenames.Add(FPackageName::LongPackageNameToFilename(CreatedPackage->GetName(),
+				FPackageName::GetAssetPackageExtension()));
+		}
+		IAssetRegistry::GetChecked().ScanModifiedAssetFiles(SavedPackageFilenames);
 	}
-	
+
+	FString NotifyMessage = TEXT("Created ") + FString::FromInt(CreatedPackages.Num()) + TEXT(" assets from ")
+		+ FString::FromInt(TextureSets.Num()) + TEXT(" texture sets");
+	if (NumSkippedSets > 0)
+	{
+		NotifyMessage += TEXT(", skipped ") + FString::FromInt(NumSkippedSets);
+	}
+	if (NumUnsavedPackages > 0)
+	{
+		NotifyMessage += TEXT(", ") + FString::FromInt(NumUnsavedPackages) + TEXT(" failed to save (see log)");
+	}
+	if (GShaderCompilingManager && GShaderCompilingManager->IsCompiling())
+	{
+		NotifyMessage += TEXT(", ") + FString::FromInt(GShaderCompilingManager->GetNumRemainingJobs()) + TEXT(" shader jobs compiling in background");
+	}
+	Debug::ShowNotifyInfo(NotifyMessage);
+}
+
+/**
+ * @brief 把纹理按所在文件夹和去掉前缀、通道后缀后的名称分组
+ * 组的顺序与纹理首次出现的顺序一致
+ * @param TexturesData 纹理
+ * @param OutTextureSets 贴图套
+ */
+void UQuickMaterialCreationWidget::GatherTextureSets(const TArray<FAssetData>& TexturesData, TArray<FMaterialTextureSet>& OutTextureSets) const
+{
+	OutTextureSets.Reset();
+
+	TMap<FString, int32> TextureSetIndices;
+	for (const FAssetData& TextureData : TexturesData)
+	{
+		const FString PackagePath = TextureData.PackagePath.ToString();
+		const FString BaseName = GetTextureSetBaseName(TextureData.AssetName.ToString());
+
+		const FString TextureSetKey = PackagePath / BaseName;
+		int32& TextureSetIndex = TextureSetIndices.FindOrAdd(TextureSetKey, INDEX_NONE);
+		if (TextureSetIndex == INDEX_NONE)
+		{
+			TextureSetIndex = OutTextureSets.AddDefaulted();
+			OutTextureSets[TextureSetIndex].PackagePath = PackagePath;
+			OutTextureSets[TextureSetIndex].BaseName = BaseName;
+		}
+		OutTextureSets[TextureSetIndex].TexturesData.Add(TextureData);
+	}
+}
+
+/**
+ * @brief 去掉纹理名的 T_ 前缀和最长的通道后缀，得到贴图套的名称
+ * @param TextureName 纹理名，如 T_Rock_BaseColor
+ * @return 贴图套名称，如 Rock
+ */
+FString UQuickMaterialCreationWidget::GetTextureSetBaseName(const FString& TextureName) const
+{
+	FString BaseName = TextureName;
+	BaseName.RemoveFromStart(TEXT("T_"));
+
+	int32 LongestSuffixLength = 0;
+	TextureSuffixMatcher.Classify(BaseName, &LongestSuffixLength);
+
+	BaseName.LeftChopInline(LongestSuffixLength);
+	return BaseName;
+}
+
+/**
+ * @brief 为一套贴图创建材质，需要时再创建材质实例，名称已被占用时跳过
+ * 使用母材质时只创建母材质的材质实例
+ * @param TextureSet 贴图套
+ * @param OutCreatedPackages 新建资产所在的包，统一在最后保存
+ * @param InOutCreatedObjectPaths 本批次已创建资产的对象路径，用于检查名称冲突
+ * @return 是否创建了材质
+ */
+bool UQuickMaterialCreationWidget::CreateMaterialForTextureSet(const FMaterialTextureSet& TextureSet, TArray<UPackage*>& OutCreatedPackages,
+	TSet<FString>& InOutCreatedObjectPaths)
+{
+	const FString NameOfMaterial = TEXT("M_") + TextureSet.BaseName;
+	const FString NameOfMaterialInstance = TEXT("MI_") + TextureSet.BaseName;
+
+	// 本批次刚创建的资产在最后统一扫描前还不在注册表中，另外对照本批次创建的对象路径
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	TArray<FString> AssetNamesToCreate;
+	if (!bUseMasterMaterial)
+	{
+		AssetNamesToCreate.Add(NameOfMaterial);
+	}
+	if (bCreateMaterialInstance || bUseMasterMaterial)
+	{
+		AssetNamesToCreate.Add(NameOfMaterialInstance);
+	}
+
+	for (const FString& AssetName : AssetNamesToCreate)
+	{
+		const FString AssetPath = TextureSet.PackagePath / AssetName + TEXT(".") + AssetName;
+		if (InOutCreatedObjectPaths.Contains(AssetPath) || AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(AssetPath)).IsValid())
+		{
+			Debug::PrintLog(AssetName + TEXT(" is already used by asset"));
+			return false;
+		}
+	}
+
+	if (bUseMasterMaterial)
+	{
+		UMaterialInstanceConstantFactoryNew* MIFactory = NewObject<UMaterialInstanceConstantFactoryNew>();
+		MIFactory->InitialParent = GetMasterMaterial();
+
+		UMaterialInstanceConstant* CreatedMI = Cast<UMaterialInstanceConstant>(CreateAssetInNewPackage(NameOfMaterialInstance,
+			TextureSet.PackagePath, UMaterialInstanceConstant::StaticClass(), MIFactory));
+		if (!CreatedMI)
+		{
+			return false;
+		}
+		OutCreatedPackages.Add(CreatedMI->GetPackage());
+		InOutCreatedObjectPaths.Add(CreatedMI->GetPathName());
+
+		TArray<UTexture2D*> Textures;
+		LoadTexturesToBind(TextureSet.TexturesData, Textures);
+
+		uint32 ParametersSetCounter = 0;
+		SetMasterMaterialTextureParameters(CreatedMI, Textures, ParametersSetCounter);
+		CreatedMI->PostEditChange();
+
+		return true;
+	}
+
+	UMaterial* CreatedMaterial = Cast<UMaterial>(CreateAssetInNewPackage(NameOfMaterial, TextureSet.PackagePath,
+		UMaterial::StaticClass(), NewObject<UMaterialFactoryNew>()));
+	if (!CreatedMaterial)
+	{
+		return false;
+	}
+	OutCreatedPackages.Add(CreatedMaterial->GetPackage());
+	InOutCreatedObjectPaths.Add(CreatedMaterial->GetPathName());
+
+	TArray<UTexture2D*> Textures;
+	LoadTexturesToBind(TextureSet.TexturesData, Textures);
+
+	uint32 PinsConnectedCounter = 0;
+	ConnectTexturesToMaterial(CreatedMaterial, Textures, PinsConnectedCounter);
+
 	if (bCreateMaterialInstance)
 	{
-		CreateMaterialInstanceAsset(CreatedMaterial, MaterialName, SelectedTextureFolderPath);
+		UMaterialInstanceConstantFactoryNew* MIFactory = NewObject<UMaterialInstanceConstantFactoryNew>();
+		MIFactory->InitialParent = CreatedMaterial;
+
+		if (UObject* CreatedMI = CreateAssetInNewPackage(NameOfMaterialInstance, TextureSet.PackagePath,
+			UMaterialInstanceConstant::StaticClass(), MIFactory))
+		{
+			OutCreatedPackages.Add(CreatedMI->GetPackage());
+			InOutCreatedObjectPaths.Add(CreatedMI->GetPathName());
+		}
 	}
 
-	MaterialName = TEXT("M_");
+	return true;
+}
+
+/**
+ * @brief 在新包中创建资产，不通知注册表也不打开编辑器，由批量流程在最后统一保存和扫描
+ * @param AssetName 资产名
+ * @param PackagePath 资产存放路径
+ * @param AssetClass 资产类型
+ * @param Factory 工厂
+ * @return 
+ */
+UObject* UQuickMaterialCreationWidget::CreateAssetInNewPackage(const FString& AssetName, const FString& PackagePath, UClass* AssetClass, UFactory* Factory)
+{
+	UPackage* Package = CreatePackage(*(PackagePath / AssetName));
+	if (!Package)
+	{
+		return nullptr;
+	}
+
+	UObject* CreatedObject = Factory->FactoryCreateNew(AssetClass, Package, FName(*AssetName), RF_Public | RF_Standalone | RF_Transactional,
+		nullptr, GWarn);
+	if (CreatedObject)
+	{
+		Package->MarkPackageDirty();
+	}
+
+	return CreatedObject;
+}
+
+#pragma endregion
+
+
+#pragma region MasterMaterial
+
+/**
+ * @brief 取当前通道打包方式对应的母材质，加载后按软引用路径缓存
+ * @return 未设置或加载失败时返回 nullptr
+ */
+UMaterialInterface* UQuickMaterialCreationWidget::GetMasterMaterial()
+{
+	const TSoftObjectPtr<UMaterialInterface>* MasterMaterialPtr = nullptr;
+	switch (ChannelPackingType)
+	{
+	case E_ChannelPackingType::ECPT_NoChannelPacking: MasterMaterialPtr = &NoChannelPackingMasterMaterial; break;
+	case E_ChannelPackingType::ECPT_ORM: MasterMaterialPtr = &ORMMasterMaterial; break;
+	case E_ChannelPackingType::ECPT_MAX: break;
+	default: ;
+	}
+
+	if (!MasterMaterialPtr || MasterMaterialPtr->IsNull())
+	{
+		return nullptr;
+	}
+
+	const FSoftObjectPath MasterMaterialPath = MasterMaterialPtr->ToSoftObjectPath();
+	if (const TObjectPtr<UMaterialInterface>* CachedMasterMaterial = CachedMasterMaterials.Find(MasterMaterialPath))
+	{
+		if (*CachedMasterMaterial)
+		{
+			return *CachedMasterMaterial;
+		}
+	}
+
+	UMaterialInterface* MasterMaterial = MasterMaterialPtr->LoadSynchronous();
+	if (MasterMaterial)
+	{
+		CachedMasterMaterials.Add(MasterMaterialPath, MasterMaterial);
+	}
+	return MasterMaterial;
+}
+
+/**
+ * @brief 为所选纹理创建母材质的材质实例并设置纹理参数
+ * @param TexturesData 纹理的资产数据
+ * @param PathToPutMI 材质实例存放路径
+ */
+void UQuickMaterialCreationWidget::CreateMasterMaterialInstance(const TArray<FAssetData>& TexturesData, FString& PathToPutMI)
+{
+	UMaterialInterface* MasterMaterial = GetMasterMaterial();
+	if (!MasterMaterial)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No master material set for the current channel packing type"));
+		return;
+	}
+
+	FString NameOfMaterialInstance = MaterialName;
+	NameOfMaterialInstance.RemoveFromStart(TEXT("M_"));
+	NameOfMaterialInstance.InsertAt(0, TEXT("MI_"));
+	if (CheckIsNameUsed(PathToPutMI, NameOfMaterialInstance))
+	{
+		return;
+	}
+
+	UMaterialInstanceConstant* CreatedMI = CreateMaterialInstanceAsset(MasterMaterial, MaterialName, PathToPutMI);
+	if (!CreatedMI)
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("Failed to create material instance"));
+		return;
+	}
+
+	TArray<UTexture2D*> Textures;
+	LoadTexturesToBind(TexturesData, Textures);
+
+	uint32 ParametersSetCounter = 0;
+	SetMasterMaterialTextureParameters(CreatedMI, Textures, ParametersSetCounter);
+	CreatedMI->PostEditChange();
+
+	if (ParametersSetCounter > 0)
+	{
+		Debug::ShowNotifyInfo(TEXT("Successfully set ") + FString::FromInt(ParametersSetCounter) + TEXT(" texture parameters"));
+	}
+}
+
+/**
+ * @brief 纹理通道对应的母材质纹理参数名
+ * @param TextureChannel 纹理通道
+ * @return 
+ */
+FName UQuickMaterialCreationWidget::GetTextureParameterName(ETextureChannel TextureChannel) const
+{
+	switch (TextureChannel)
+	{
+	case ETextureChannel::BaseColor:		return BaseColorParameterName;
+	case ETextureChannel::Metallic:			return MetallicParameterName;
+	case ETextureChannel::Roughness:		return RoughnessParameterName;
+	case ETextureChannel::Normal:			return NormalParameterName;
+	case ETextureChannel::AmbientOcclusion:	return AmbientOcclusionParameterName;
+	case ETextureChannel::ORM:				return ORMParameterName;
+	default: ;
+	}
+	return NAME_None;
+}
+
+/**
+ * @brief 按纹理名把纹理设置到材质实例的纹理参数上，每个通道只设置一次
+ * 只覆盖纹理参数，材质实例与母材质共用着色器
+ * @param MaterialInstance 材质实例
+ * @param Textures 纹理
+ * @param ParametersSetCounter 参数计数
+ */
+void UQuickMaterialCreationWidget::SetMasterMaterialTextureParameters(UMaterialInstanceConstant* MaterialInstance, const TArray<UTexture2D*>& Textures,
+	uint32& ParametersSetCounter)
+{
+	TSet<ETextureChannel> SetChannels;
+	for (UTexture2D* Texture : Textures)
+	{
+		if (!Texture) continue;
+
+		const ETextureChannel TextureChannel = TextureSuffixMatcher.Classify(Texture->GetName());
+		const FName ParameterName = GetTextureParameterName(TextureChannel);
+
+		bool bChannelAlreadySet = false;
+		SetChannels.Add(TextureChannel, &bChannelAlreadySet);
+		if (ParameterName.IsNone() || bChannelAlreadySet)
+		{
+			Debug::PrintLog(TEXT("Failed to set the texture: ") + Texture->GetName());
+			continue;
+		}
+
+		// 母材质中没有这个参数时覆盖值不会生效
+		const FMaterialParameterInfo ParameterInfo(ParameterName);
+		UTexture* DefaultTexture = nullptr;
+		if (!MaterialInstance->Parent || !MaterialInstance->Parent->GetTextureParameterValue(ParameterInfo, DefaultTexture))
+		{
+			Debug::PrintLog(TEXT("Master material has no texture parameter: ") + ParameterName.ToString());
+			continue;
+		}
+
+		// 纹理设置与母材质中采样器的采样类型保持一致
+		switch (TextureChannel)
+		{
+		case ETextureChannel::Metallic:
+		case ETextureChannel::Roughness:
+		case ETextureChannel::AmbientOcclusion:
+			SetLinearTextureSettings(Texture, TextureCompressionSettings::TC_Default);
+			break;
+		case ETextureChannel::ORM:
+			SetLinearTextureSettings(Texture, TextureCompressionSettings::TC_Masks);
+			break;
+		default: ;
+		}
+
+		MaterialInstance->SetTextureParameterValueEditorOnly(ParameterInfo, Texture);
+		ParametersSetCounter++;
+	}
 }
 
 #pragma endregion
@@ -88,14 +535,14 @@ void UQuickMaterialCreationWidget::CreateMaterialFromSelectedTextures()
 #pragma region QuickMaterialCreation
 
 /**
- * @brief 处理所选资产
+ * @brief 处理所选资产，类型和名称都从 FAssetData 读取，不加载纹理
  * @param SelectedDataToProcess 资产数据
- * @param OutSelectedTexturesArray 纹理数据
+ * @param OutSelectedTexturesData 纹理的资产数据
  * @param OutSelectedTexturePackagePath 纹理所属文件夹路径
  * @return 
  */
 bool UQuickMaterialCreationWidget::ProcessSelectedData(const TArray<FAssetData>& SelectedDataToProcess,
-	TArray<UTexture2D*>& OutSelectedTexturesArray, FString& OutSelectedTexturePackagePath)
+	TArray<FAssetData>& OutSelectedTexturesData, FString& OutSelectedTexturePackagePath)
 {
 	if (SelectedDataToProcess.Num() == 0)
 	{
@@ -107,19 +554,17 @@ bool UQuickMaterialCreationWidget::ProcessSelectedData(const TArray<FAssetData>&
 
 	for (const FAssetData& SelectedData : SelectedDataToProcess)
 	{
-		UObject* SelectedAsset = SelectedData.GetAsset();
-		if (!SelectedAsset) continue;
-
-		UTexture2D* SelectedTexture2D = Cast<UTexture2D>(SelectedAsset);
+		if (!SelectedData.IsValid()) continue;
 
-		if (!SelectedTexture2D)
+		// 只查找已加载的类，不会加载资产本身
+		if (!SelectedData.IsInstanceOf(UTexture2D::StaticClass()))
 		{
 			Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("Please select only Texture.\n") +
-				SelectedAsset->GetName() + TEXT(" is no a Texture asset"));
+				SelectedData.AssetName.ToString() + TEXT(" is no a Texture asset"));
 			return false;
 		}
 
-		OutSelectedTexturesArray.Add(SelectedTexture2D);
+		OutSelectedTexturesData.Add(SelectedData);
 
 		if (OutSelectedTexturePackagePath.IsEmpty())
 		{
@@ -128,7 +573,7 @@ bool UQuickMaterialCreationWidget::ProcessSelectedData(const TArray<FAssetData>&
 
 		if (!bOverrideMaterialName && !bMaterialNameSet)
 		{
-			MaterialName = SelectedAsset->GetName();
+			MaterialName = SelectedData.AssetName.ToString();
 			MaterialName.RemoveFromStart(TEXT("T_"));
 			MaterialName.InsertAt(0, TEXT("M_"));
 
@@ -139,6 +584,103 @@ bool UQuickMaterialCreationWidget::ProcessSelectedData(const TArray<FAssetData>&
 	return true;
 }
 
+/**
+ * @brief 按名称判断纹理在当前通道打包方式下能否连接到某个引脚，与 *_CreateMaterialNodes 的分类一致
+ * @param TextureName 纹理名
+ * @return 
+ */
+bool UQuickMaterialCreationWidget::CanTextureBeBound(const FString& TextureName) const
+{
+	const ETextureChannel TextureChannel = TextureSuffixMatcher.Classify(TextureName);
+	switch (ChannelPackingType)
+	{
+	case E_ChannelPackingType::ECPT_NoChannelPacking:
+		return TextureChannel != ETextureChannel::None && TextureChannel != ETextureChannel::ORM;
+	case E_ChannelPackingType::ECPT_ORM:
+		return TextureChannel == ETextureChannel::BaseColor || TextureChannel == ETextureChannel::Normal || TextureChannel == ETextureChannel::ORM;
+	case E_ChannelPackingType::ECPT_MAX: break;
+	default: ;
+	}
+	return false;
+}
+
+/**
+ * @brief 所有后缀表编译成一棵倒序后缀树，后缀表没有变化时不重新编译
+ * 后缀表可能在细节面板或蓝图中被修改，每次创建材质前比较一次后缀表的哈希
+ */
+void UQuickMaterialCreationWidget::EnsureTextureSuffixMatcherUpToDate()
+{
+	const TPair<const TArray<FString>*, ETextureChannel> SuffixTables[] =
+	{
+		{&BaseColorArray, ETextureChannel::BaseColor},
+		{&MetallicArray, ETextureChannel::Metallic},
+		{&RoughnessArray, ETextureChannel::Roughness},
+		{&NormalArray, ETextureChannel::Normal},
+		{&AmbientOcclusionArray, ETextureChannel::AmbientOcclusion},
+		{&ORMArray, ETextureChannel::ORM},
+	};
+
+	uint32 SuffixTablesHash = 0;
+	for (const TPair<const TArray<FString>*, ETextureChannel>& SuffixTable : SuffixTables)
+	{
+		SuffixTablesHash = HashCombine(SuffixTablesHash, GetTypeHash(SuffixTable.Key->Num()));
+		for (const FString& Suffix : *SuffixTable.Key)
+		{
+			SuffixTablesHash = HashCombine(SuffixTablesHash, GetTypeHash(Suffix));
+		}
+	}
+
+	if (bTextureSuffixMatcherCompiled && SuffixTablesHash == CompiledSuffixTablesHash)
+	{
+		return;
+	}
+
+	TextureSuffixMatcher.Reset();
+	for (const TPair<const TArray<FString>*, ETextureChannel>& SuffixTable : SuffixTables)
+	{
+		TextureSuffixMatcher.AddSuffixes(*SuffixTable.Key, SuffixTable.Value);
+	}
+
+	CompiledSuffixTablesHash = SuffixTablesHash;
+	bTextureSuffixMatcherCompiled = true;
+}
+
+/**
+ * @brief 只加载会被连接到采样器的纹理
+ * 未加载的纹理一次全部发起异步加载，并行读取，全部完成后再返回；顺序与输入一致
+ * @param TexturesData 纹理的资产数据
+ * @param OutTextures 加载后的纹理
+ */
+void UQuickMaterialCreationWidget::LoadTexturesToBind(const TArray<FAssetData>& TexturesData, TArray<UTexture2D*>& OutTextures) const
+{
+	TArray<const FAssetData*> TexturesDataToBind;
+	TArray<int32> LoadRequestIds;
+	for (const FAssetData& TextureData : TexturesData)
+	{
+		if (!CanTextureBeBound(TextureData.AssetName.ToString()))
+		{
+			continue;
+		}
+
+		TexturesDataToBind.Add(&TextureData);
+		if (!TextureData.IsAssetLoaded())
+		{
+			LoadRequestIds.Add(LoadPackageAsync(TextureData.PackageName.ToString()));
+		}
+	}
+
+	for (const int32 LoadRequestId : LoadRequestIds)
+	{
+		FlushAsyncLoading(LoadRequestId);
+	}
+
+	OutTextures.Reset(TexturesDataToBind.Num());
+	for (const FAssetData* TextureData : TexturesDataToBind)
+	{
+		OutTextures.Add(Cast<UTexture2D>(TextureData->FastGetAsset(false)));
+	}
+}
+
 /**
  * @brief 检查文件夹内是否已有同名材质
  * @param FolderPathToCheck 文件夹路径
@@ -183,55 +725,69 @@ UMaterial* UQuickMaterialCreationWidget::CreateMaterialAsset(const FString& Name
  */
 void UQuickMaterialCreationWidget::Default_CreateMaterialNodes(UMaterial* CreatedMaterial, UTexture2D* SelectedTexture, uint32& PinsConnectedCounter)
 {
-	UMaterialExpressionTextureSample* TextureSampleNode = NewObject<UMaterialExpressionTextureSample>(CreatedMaterial);
-	if (!TextureSampleNode) return;
-	
-	if (!CreatedMaterial->HasBaseColorConnected())
-	{
-		if (TryConnectBaseColorSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter++;
-			return;
-		}
-	}
+	// 名称只分类一次，命中的通道已被占用时不再尝试其他通道
+	const ETextureChannel TextureChannel = TextureSuffixMatcher.Classify(SelectedTexture->GetName());
 
-	if (!CreatedMaterial->HasMetallicConnected())
+	bool bCanConnect = false;
+	switch (TextureChannel)
 	{
-		if (TryConnectMetallicSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter++;
-			return;
-		}
+	case ETextureChannel::BaseColor:		bCanConnect = !CreatedMaterial->HasBaseColorConnected(); break;
+	case ETextureChannel::Metallic:			bCanConnect = !CreatedMaterial->HasMetallicConnected(); break;
+	case ETextureChannel::Roughness:		bCanConnect = !CreatedMaterial->HasRoughnessConnected(); break;
+	case ETextureChannel::Normal:			bCanConnect = !CreatedMaterial->HasNormalConnected(); break;
+	case ETextureChannel::AmbientOcclusion:	bCanConnect = !CreatedMaterial->HasAmbientOcclusionConnected(); break;
+	default: ;
 	}
 
-	if (!CreatedMaterial->HasRoughnessConnected())
+	if (!bCanConnect)
 	{
-		if (TryConnectRoughnessSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter++;
-			return;
-		}
+		Debug::PrintLog(TEXT("Failed to connect the texture: " + SelectedTexture->GetName()));
+		return;
 	}
 
-	if (!CreatedMaterial->HasNormalConnected())
+	UMaterialExpressionTextureSample* TextureSampleNode = NewObject<UMaterialExpressionTextureSample>(CreatedMaterial);
+	if (!TextureSampleNode) return;
+
+	switch (TextureChannel)
 	{
-		if (TryConnectNormalSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter++;
-			return;
-		}
+	case ETextureChannel::BaseColor:		ConnectBaseColorSocket(TextureSampleNode, SelectedTexture, CreatedMaterial); break;
+	case ETextureChannel::Metallic:			ConnectMetallicSocket(TextureSampleNode, SelectedTexture, CreatedMaterial); break;
+	case ETextureChannel::Roughness:		ConnectRoughnessSocket(TextureSampleNode, SelectedTexture, CreatedMaterial); break;
+	case ETextureChannel::Normal:			ConnectNormalSocket(TextureSampleNode, SelectedTexture, CreatedMaterial); break;
+	case ETextureChannel::AmbientOcclusion:	ConnectAOSocket(TextureSampleNode, SelectedTexture, CreatedMaterial); break;
+	default: ;
 	}
 
-	if (!CreatedMaterial->HasAmbientOcclusionConnected())
+	PinsConnectedCounter++;
+}
+
+/**
+ * @brief 按通道打包方式把纹理逐个连接到材质
+ * 连接引脚时不触发重新编译，所有节点建好后只调用一次 PostEditChange
+ * @param CreatedMaterial 材质
+ * @param Textures 纹理
+ * @param PinsConnectedCounter 引脚计数
+ */
+void UQuickMaterialCreationWidget::ConnectTexturesToMaterial(UMaterial* CreatedMaterial, const TArray<UTexture2D*>& Textures, uint32& PinsConnectedCounter)
+{
+	for (UTexture2D* Texture : Textures)
 	{
-		if (TryConnectAOSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
+		if (!Texture) continue;
+
+		switch (ChannelPackingType)
 		{
-			PinsConnectedCounter++;
-			return;
+		case E_ChannelPackingType::ECPT_NoChannelPacking:
+			Default_CreateMaterialNodes(CreatedMaterial, Texture, PinsConnectedCounter);
+			break;
+		case E_ChannelPackingType::ECPT_ORM:
+			ORM_CreateMaterialNodes(CreatedMaterial, Texture, PinsConnectedCounter);
+			break;
+		case E_ChannelPackingType::ECPT_MAX: break;
+		default: ;
 		}
 	}
 
-	Debug::PrintLog(TEXT("Failed to connect the texture: " + SelectedTexture->GetName()));
+	CreatedMaterial->PostEditChange();
 }
 
 /**
@@ -242,34 +798,37 @@ void UQuickMaterialCreationWidget::Default_CreateMaterialNodes(UMaterial* Create
  */
 void UQuickMaterialCreationWidget::ORM_CreateMaterialNodes(UMaterial* CreatedMaterial, UTexture2D* SelectedTexture, uint32& PinsConnectedCounter)
 {
-	UMaterialExpressionTextureSample* TextureSampleNode = NewObject<UMaterialExpressionTextureSample>(CreatedMaterial);
-	if (!TextureSampleNode) return;
-	
-	if (!CreatedMaterial->HasBaseColorConnected())
-	{
-		if (TryConnectBaseColorSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter++;
-			return;
-		}
-	}
+	const ETextureChannel TextureChannel = TextureSuffixMatcher.Classify(SelectedTexture->GetName());
 
-	if (!CreatedMaterial->HasNormalConnected())
+	bool bCanConnect = false;
+	switch (TextureChannel)
 	{
-		if (TryConnectNormalSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter++;
-			return;
-		}
+	case ETextureChannel::BaseColor:	bCanConnect = !CreatedMaterial->HasBaseColorConnected(); break;
+	case ETextureChannel::Normal:		bCanConnect = !CreatedMaterial->HasNormalConnected(); break;
+	case ETextureChannel::ORM:			bCanConnect = !CreatedMaterial->HasRoughnessConnected(); break;
+	default: ;
 	}
 
-	if (!CreatedMaterial->HasRoughnessConnected())
+	if (!bCanConnect) return;
+
+	UMaterialExpressionTextureSample* TextureSampleNode = NewObject<UMaterialExpressionTextureSample>(CreatedMaterial);
+	if (!TextureSampleNode) return;
+
+	switch (TextureChannel)
 	{
-		if (TryConnectORMSocket(TextureSampleNode, SelectedTexture, CreatedMaterial))
-		{
-			PinsConnectedCounter += 3;
-			return;
-		}
+	case ETextureChannel::BaseColor:
+		ConnectBaseColorSocket(TextureSampleNode, SelectedTexture, CreatedMaterial);
+		PinsConnectedCounter++;
+		break;
+	case ETextureChannel::Normal:
+		ConnectNormalSocket(TextureSampleNode, SelectedTexture, CreatedMaterial);
+		PinsConnectedCounter++;
+		break;
+	case ETextureChannel::ORM:
+		ConnectORMSocket(TextureSampleNode, SelectedTexture, CreatedMaterial);
+		PinsConnectedCounter += 3;
+		break;
+	default: ;
 	}
 }
 
@@ -283,28 +842,17 @@ void UQuickMaterialCreationWidget::ORM_CreateMaterialNodes(UMaterial* CreatedMat
  * @param TextureSampleNode 采样器
  * @param SelectedTexture 纹理
  * @param CreatedMaterial 材质
- * @return 
  */
-bool UQuickMaterialCreationWidget::TryConnectBaseColorSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+void UQuickMaterialCreationWidget::ConnectBaseColorSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
 {
-	for (const FString& BaseColorName : BaseColorArray)
-	{
-		if (SelectedTexture->GetName().Contains(BaseColorName))
-		{
-			// 指定采样纹理
-			TextureSampleNode->Texture = SelectedTexture;
-			// 调整节点的画布位置
-			TextureSampleNode->MaterialExpressionEditorX -= 600;
-
-			// 将采样器节点连接到材质表达式
-			CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_BaseColor)->Connect(0, TextureSampleNode);
-			CreatedMaterial->PostEditChange();
-			
-			return true;
-		}
-	}
-	return false;
+	// 指定采样纹理
+	TextureSampleNode->Texture = SelectedTexture;
+	// 调整节点的画布位置
+	TextureSampleNode->MaterialExpressionEditorX -= 600;
+
+	// 将采样器节点连接到材质表达式
+	CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_BaseColor)->Connect(0, TextureSampleNode);
 }
 
 /**
@@ -312,32 +860,18 @@ bool UQuickMaterialCreationWidget::TryConnectBaseColorSocket(UMaterialExpression
  * @param TextureSampleNode 采样器
  * @param SelectedTexture 纹理
  * @param CreatedMaterial 材质
- * @return 
  */
-bool UQuickMaterialCreationWidget::TryConnectMetallicSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+void UQuickMaterialCreationWidget::ConnectMetallicSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
 {
-	for (const FString& MetallicName : MetallicArray)
-	{
-		if (SelectedTexture->GetName().Contains(MetallicName))
-		{
-			SelectedTexture->CompressionSettings = TextureCompressionSettings::TC_Default;
-			SelectedTexture->SRGB = false;
-			SelectedTexture->PostEditChange();
+	SetLinearTextureSettings(SelectedTexture, TextureCompressionSettings::TC_Default);
 
-			TextureSampleNode->Texture = SelectedTexture;
-			TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
-			TextureSampleNode->MaterialExpressionEditorX -= 600;
-			TextureSampleNode->MaterialExpressionEditorY += 250;
+	TextureSampleNode->Texture = SelectedTexture;
+	TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
+	TextureSampleNode->MaterialExpressionEditorX -= 600;
+	TextureSampleNode->MaterialExpressionEditorY += 250;
 
-			CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_Metallic)->Connect(0, TextureSampleNode);
-			CreatedMaterial->PostEditChange();
-
-			return true;
-		}
-	}
-
-	return false;
+	CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_Metallic)->Connect(0, TextureSampleNode);
 }
 
 /**
@@ -345,32 +879,18 @@ bool UQuickMaterialCreationWidget::TryConnectMetallicSocket(UMaterialExpressionT
  * @param TextureSampleNode 采样器
  * @param SelectedTexture 纹理
  * @param CreatedMaterial 材质
- * @return 
  */
-bool UQuickMaterialCreationWidget::TryConnectRoughnessSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+void UQuickMaterialCreationWidget::ConnectRoughnessSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
 {
-	for (const FString& RoughnessName : RoughnessArray)
-	{
-		if (SelectedTexture->GetName().Contains(RoughnessName))
-		{
-			SelectedTexture->CompressionSettings = TextureCompressionSettings::TC_Default;
-			SelectedTexture->SRGB = false;
-			SelectedTexture->PostEditChange();
+	SetLinearTextureSettings(SelectedTexture, TextureCompressionSettings::TC_Default);
 
-			TextureSampleNode->Texture = SelectedTexture;
-			TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
-			TextureSampleNode->MaterialExpressionEditorX -= 600;
-			TextureSampleNode->MaterialExpressionEditorY += 500;
-
-			CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_Roughness)->Connect(0, TextureSampleNode);
-			CreatedMaterial->PostEditChange();
-
-			return true;
-		}
-	}
+	TextureSampleNode->Texture = SelectedTexture;
+	TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
+	TextureSampleNode->MaterialExpressionEditorX -= 600;
+	TextureSampleNode->MaterialExpressionEditorY += 500;
 
-	return false;
+	CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_Roughness)->Connect(0, TextureSampleNode);
 }
 
 /**
@@ -378,32 +898,20 @@ bool UQuickMaterialCreationWidget::TryConnectRoughnessSocket(UMaterialExpression
  * @param TextureSampleNode 采样器
  * @param SelectedTexture 纹理
  * @param CreatedMaterial 材质
- * @return 
  */
-bool UQuickMaterialCreationWidget::TryConnectNormalSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+void UQuickMaterialCreationWidget::ConnectNormalSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
 {
-	for (const FString& NormalName : NormalArray)
-	{
-		if (SelectedTexture->GetName().Contains(NormalName))
-		{
-			// SelectedTexture->CompressionSettings = TextureCompressionSettings::TC_Default;
-			// SelectedTexture->SRGB = false;
-			// SelectedTexture->PostEditChange();
+	// SelectedTexture->CompressionSettings = TextureCompressionSettings::TC_Default;
+	// SelectedTexture->SRGB = false;
+	// SelectedTexture->PostEditChange();
 
-			TextureSampleNode->Texture = SelectedTexture;
-			TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_Normal;
-			TextureSampleNode->MaterialExpressionEditorX -= 600;
-			TextureSampleNode->MaterialExpressionEditorY += 750;
+	TextureSampleNode->Texture = SelectedTexture;
+	TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_Normal;
+	TextureSampleNode->MaterialExpressionEditorX -= 600;
+	TextureSampleNode->MaterialExpressionEditorY += 750;
 
-			CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_Normal)->Connect(0, TextureSampleNode);
-			CreatedMaterial->PostEditChange();
-
-			return true;
-		}
-	}
-
-	return false;
+	CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_Normal)->Connect(0, TextureSampleNode);
 }
 
 /**
@@ -411,32 +919,18 @@ bool UQuickMaterialCreationWidget::TryConnectNormalSocket(UMaterialExpressionTex
  * @param TextureSampleNode 采样器
  * @param SelectedTexture 纹理
  * @param CreatedMaterial 材质
- * @return 
  */
-bool UQuickMaterialCreationWidget::TryConnectAOSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+void UQuickMaterialCreationWidget::ConnectAOSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
 {
-	for (const FString& AOName : AmbientOcclusionArray)
-	{
-		if (SelectedTexture->GetName().Contains(AOName))
-		{
-			SelectedTexture->CompressionSettings = TextureCompressionSettings::TC_Default;
-			SelectedTexture->SRGB = false;
-			SelectedTexture->PostEditChange();
+	SetLinearTextureSettings(SelectedTexture, TextureCompressionSettings::TC_Default);
 
-			TextureSampleNode->Texture = SelectedTexture;
-			TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
-			TextureSampleNode->MaterialExpressionEditorX -= 600;
-			TextureSampleNode->MaterialExpressionEditorY += 1000;
-
-			CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_AmbientOcclusion)->Connect(0, TextureSampleNode);
-			CreatedMaterial->PostEditChange();
-
-			return true;
-		}
-	}
+	TextureSampleNode->Texture = SelectedTexture;
+	TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_LinearColor;
+	TextureSampleNode->MaterialExpressionEditorX -= 600;
+	TextureSampleNode->MaterialExpressionEditorY += 1000;
 
-	return false;
+	CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_AmbientOcclusion)->Connect(0, TextureSampleNode);
 }
 
 /**
@@ -444,34 +938,37 @@ bool UQuickMaterialCreationWidget::TryConnectAOSocket(UMaterialExpressionTexture
  * @param TextureSampleNode 采样器
  * @param SelectedTexture 纹理
  * @param CreatedMaterial 材质
- * @return 
  */
-bool UQuickMaterialCreationWidget::TryConnectORMSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+void UQuickMaterialCreationWidget::ConnectORMSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial)
+{
+	SetLinearTextureSettings(SelectedTexture, TextureCompressionSettings::TC_Masks);
+
+	TextureSampleNode->Texture = SelectedTexture;
+	TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_Masks;
+	TextureSampleNode->MaterialExpressionEditorX -= 600;
+	TextureSampleNode->MaterialExpressionEditorY += 250;
+
+	CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_AmbientOcclusion)->Connect(1, TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_Roughness)->Connect(2, TextureSampleNode);
+	CreatedMaterial->GetExpressionInputForProperty(MP_Metallic)->Connect(3, TextureSampleNode);
+}
+
+/**
+ * @brief 把纹理设置为线性采样，设置没有变化时不调用 PostEditChange，避免重新构建纹理
+ * @param SelectedTexture 纹理
+ * @param CompressionSettings 压缩设置
+ */
+void UQuickMaterialCreationWidget::SetLinearTextureSettings(UTexture2D* SelectedTexture, TextureCompressionSettings CompressionSettings)
 {
-	for (const FString& ORMName : ORMArray)
+	if (SelectedTexture->CompressionSettings == CompressionSettings && !SelectedTexture->SRGB)
 	{
-		if (SelectedTexture->GetName().Contains(ORMName))
-		{
-			SelectedTexture->CompressionSettings = TextureCompressionSettings::TC_Masks;
-			SelectedTexture->SRGB = false;
-			SelectedTexture->PostEditChange();
-
-			TextureSampleNode->Texture = SelectedTexture;
-			TextureSampleNode->SamplerType = EMaterialSamplerType::SAMPLERTYPE_Masks;
-			TextureSampleNode->MaterialExpressionEditorX -= 600;
-			TextureSampleNode->MaterialExpressionEditorY += 250;
-
-			CreatedMaterial->GetExpressionCollection().AddExpression(TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_AmbientOcclusion)->Connect(1, TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_Roughness)->Connect(2, TextureSampleNode);
-			CreatedMaterial->GetExpressionInputForProperty(MP_Metallic)->Connect(3, TextureSampleNode);
-			CreatedMaterial->PostEditChange();
-			
-			return true;
-		}
+		return;
 	}
-	
-	return false;
+
+	SelectedTexture->CompressionSettings = CompressionSettings;
+	SelectedTexture->SRGB = false;
+	SelectedTexture->PostEditChange();
 }
 
 #pragma endregion
@@ -479,28 +976,21 @@ bool UQuickMaterialCreationWidget::TryConnectORMSocket(UMaterialExpressionTextur
 
 /**
  * @brief 创建材质实例
+ * 父材质在创建时由工厂设置，设置好参数后由调用方调用一次 PostEditChange
  * @param ParentMaterial 父材质
  * @param NameOfMaterialInstance 材质实例名
  * @param PathToPutMI 材质实例存放路径
  * @return 
  */
-UMaterialInstanceConstant* UQuickMaterialCreationWidget::CreateMaterialInstanceAsset(UMaterial* ParentMaterial, FString& NameOfMaterialInstance, FString& PathToPutMI)
+UMaterialInstanceConstant* UQuickMaterialCreationWidget::CreateMaterialInstanceAsset(UMaterialInterface* ParentMaterial, FString& NameOfMaterialInstance, FString& PathToPutMI)
 {
 	NameOfMaterialInstance.RemoveFromStart(TEXT("M_"));
 	NameOfMaterialInstance.InsertAt(0, TEXT("MI_"));
 
 	const FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
 	UMaterialInstanceConstantFactoryNew* MIFactory = NewObject<UMaterialInstanceConstantFactoryNew>();
+	MIFactory->InitialParent = ParentMaterial;
 	UObject* CreatedObject = AssetToolsModule.Get().CreateAsset(NameOfMaterialInstance, PathToPutMI, UMaterialInstanceConstant::StaticClass(), MIFactory);
 
-	if (UMaterialInstanceConstant* CreatedMI = Cast<UMaterialInstanceConstant>(CreatedObject))
-	{
-		CreatedMI->SetParentEditorOnly(ParentMaterial);
-		CreatedMI->PostEditChange();
-		ParentMaterial->PostEditChange();
-
-		return CreatedMI;
-	}
-
-	return nullptr;
+	return Cast<UMaterialInstanceConstant>(CreatedObject);
 }
\ No newline at end of file
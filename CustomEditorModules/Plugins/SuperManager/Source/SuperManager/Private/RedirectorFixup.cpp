@@ -0,0 +1,521 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "RedirectorFixup.h"
+
+#include "AssetToolsModule.h"
+#include "DebugHeader.h"
+#include "ISourceControlModule.h"
+#include "SourceControlHelpers.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/ObjectRedirector.h"
+
+namespace
+{
+	/** PackagePath 等于 ParentPath 或位于其下 */
+	bool IsPathUnder(FStringView PackagePath, FStringView ParentPath)
+	{
+		ParentPath.RemoveSuffix(ParentPath.EndsWith(TEXT('/')) ? 1 : 0);
+
+		return PackagePath.StartsWith(ParentPath, ESearchCase::IgnoreCase)
+			&& (PackagePath.Len() == ParentPath.Len() || PackagePath[ParentPath.Len()] == TEXT('/'));
+	}
+
+	bool IsPathUnderAny(FStringView PackagePath, const TArray<FString>& ParentPaths)
+	{
+		for (const FString& ParentPath : ParentPaths)
+		{
+			if (IsPathUnder(PackagePath, ParentPath))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+/**
+ * @brief 修复与给定目录相关的重定向器，以及上次没有完成的重定向器
+ * 没有需要修复的重定向器时立即调用回调，否则在全部批次完成后调用，取消时不调用
+ * @param PackagePaths 目录，例如 /Game/Textures
+ * @param OnCompleted 修复结束后在游戏线程调用
+ * @return 已有修复正在进行时返回 false，此时不会调用回调
+ */
+bool FRedirectorFixup::FixUpRedirectorsInPaths(const TArray<FString>& PackagePaths, const FOnFixupCompleted& OnCompleted)
+{
+	if (bIsRunning)
+	{
+		Debug::ShowNotifyInfo(TEXT("Redirector fixup is already running"));
+		return false;
+	}
+
+	GatherKnownRedirectors();
+
+	TArray<FAssetData> RedirectorsData;
+	GatherRedirectorsInScope(PackagePaths, RedirectorsData);
+	GatherResumedRedirectors(RedirectorsData);
+
+	if (RedirectorsData.Num() == 0)
+	{
+		OnCompleted.ExecuteIfBound();
+		return true;
+	}
+
+	bIsRunning = true;
+	bCancelRequested = false;
+	++CurrentFixupRunId;
+	OnFixupCompleted = OnCompleted;
+
+	BuildFixupBatches(MoveTemp(RedirectorsData));
+	CurrentBatchIndex = 0;
+	SaveResumeFile();
+
+	ProgressNotification = Debug::ShowProgressNotify(
+		TEXT("Fixing up redirectors..."),
+		FSimpleDelegate::CreateRaw(this, &FRedirectorFixup::Cancel));
+
+	StartNextBatch();
+	return true;
+}
+
+/**
+ * @brief 只列出与给定目录相关的重定向器，不做修复
+ */
+void FRedirectorFixup::GatherRedirectorsInPaths(const TArray<FString>& PackagePaths, TArray<FAssetData>& OutRedirectorsData)
+{
+	OutRedirectorsData.Reset();
+
+	GatherKnownRedirectors();
+	GatherRedirectorsInScope(PackagePaths, OutRedirectorsData);
+}
+
+/**
+ * @brief 请求取消，正在修复的批次完成后停止，剩余的重定向器保留在续做文件中
+ */
+void FRedirectorFixup::Cancel()
+{
+	if (bIsRunning)
+	{
+		bCancelRequested = true;
+	}
+}
+
+/**
+ * @brief 清空已知的重定向器，下次使用时重新收集
+ * @return 修复正在进行时拒绝重置并返回 false，避免丢掉尚未调用的完成回调
+ */
+bool FRedirectorFixup::Reset()
+{
+	if (bIsRunning)
+	{
+		return false;
+	}
+
+	ResetState();
+	return true;
+}
+
+/**
+ * @brief 无条件停止修复（模块关闭或命令行等待超时），尚未调用的完成回调被丢弃，剩余的重定向器保留在续做文件中
+ */
+void FRedirectorFixup::Shutdown()
+{
+	ResetState();
+}
+
+void FRedirectorFixup::ResetState()
+{
+	if (ProcessBatchTickerHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(ProcessBatchTickerHandle);
+		ProcessBatchTickerHandle.Reset();
+	}
+
+	KnownRedirectors.Empty();
+	FailedRedirectorPackageNames.Empty();
+	bKnownRedirectorsGathered = false;
+
+	FixupBatches.Empty();
+	CurrentBatchIndex = 0;
+	NumPendingLoads = 0;
+	OnFixupCompleted.Unbind();
+	bIsRunning = false;
+	bCancelRequested = false;
+	++CurrentFixupRunId;
+
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->ExpireAndFadeout();
+		ProgressNotification.Reset();
+	}
+}
+
+void FRedirectorFixup::OnAssetAdded(const FAssetData& AssetData)
+{
+	// 尚未收集时，首次使用会从注册表完整收集一次
+	if (bKnownRedirectorsGathered && AssetData.IsRedirector())
+	{
+		KnownRedirectors.Add(AssetData.PackageName, AssetData);
+		FailedRedirectorPackageNames.Remove(AssetData.PackageName);
+	}
+}
+
+void FRedirectorFixup::OnAssetRemoved(const FAssetData& AssetData)
+{
+	if (bKnownRedirectorsGathered && AssetData.IsRedirector())
+	{
+		KnownRedirectors.Remove(AssetData.PackageName);
+		FailedRedirectorPackageNames.Remove(AssetData.PackageName);
+	}
+}
+
+void FRedirectorFixup::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	// 重命名留下的新重定向器会另外触发 OnAssetAdded，这里只需处理重定向器本身被移动的情况
+	if (bKnownRedirectorsGathered && AssetData.IsRedirector())
+	{
+		const FName OldPackageName(*FPackageName::ObjectPathToPackageName(OldObjectPath));
+		KnownRedirectors.Remove(OldPackageName);
+		FailedRedirectorPackageNames.Remove(OldPackageName);
+
+		KnownRedirectors.Add(AssetData.PackageName, AssetData);
+	}
+}
+
+/**
+ * @brief 从注册表收集 /Game 下的所有重定向器，只读取注册表数据，不加载任何包
+ */
+void FRedirectorFixup::GatherKnownRedirectors()
+{
+	if (bKnownRedirectorsGathered)
+	{
+		return;
+	}
+
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	Filter.PackagePaths.Add("/Game");
+	Filter.ClassPaths.Add(UObjectRedirector::StaticClass()->GetClassPathName());
+
+	TArray<FAssetData> RedirectorsData;
+	IAssetRegistry::GetChecked().GetAssets(Filter, RedirectorsData);
+
+	KnownRedirectors.Empty(RedirectorsData.Num());
+	for (const FAssetData& RedirectorData : RedirectorsData)
+	{
+		KnownRedirectors.Add(RedirectorData.PackageName, RedirectorData);
+	}
+
+	// 启动扫描结束之前收集的结果不完整，之后仍需重新收集
+	bKnownRedirectorsGathered = !IAssetRegistry::GetChecked().IsLoadingAssets();
+}
+
+/**
+ * @brief 找出位于目录下，或者依赖目录下资产的重定向器
+ * 重定向器包对目标包有硬依赖，通过注册表的依赖关系判断指向，不需要加载
+ */
+void FRedirectorFixup::GatherRedirectorsInScope(const TArray<FString>& PackagePaths, TArray<FAssetData>& OutRedirectorsData) const
+{
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	TArray<FName> DestinationPackageNames;
+	for (const TPair<FName, FAssetData>& KnownRedirector : KnownRedirectors)
+	{
+		if (FailedRedirectorPackageNames.Contains(KnownRedirector.Key))
+		{
+			continue;
+		}
+
+		const FAssetData& RedirectorData = KnownRedirector.Value;
+		if (IsPathUnderAny(FNameBuilder(RedirectorData.PackagePath).ToView(), PackagePaths))
+		{
+			OutRedirectorsData.Add(RedirectorData);
+			continue;
+		}
+
+		DestinationPackageNames.Reset();
+		AssetRegistry.GetDependencies(RedirectorData.PackageName, DestinationPackageNames, UE::AssetRegistry::EDependencyCategory::Package);
+
+		for (const FName DestinationPackageName : DestinationPackageNames)
+		{
+			if (IsPathUnderAny(FNameBuilder(DestinationPackageName).ToView(), PackagePaths))
+			{
+				OutRedirectorsData.Add(RedirectorData);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * @brief 加入上次被取消或因崩溃中断的重定向器，只保留仍然存在的
+ */
+void FRedirectorFixup::GatherResumedRedirectors(TArray<FAssetData>& InOutRedirectorsData) const
+{
+	TArray<FString> ResumedPackageNames;
+	if (!FFileHelper::LoadFileToStringArray(ResumedPackageNames, *GetResumeFilePath()))
+	{
+		return;
+	}
+
+	TSet<FName> ScopedPackageNames;
+	for (const FAssetData& RedirectorData : InOutRedirectorsData)
+	{
+		ScopedPackageNames.Add(RedirectorData.PackageName);
+	}
+
+	for (const FString& ResumedPackageName : ResumedPackageNames)
+	{
+		const FName PackageName(*ResumedPackageName);
+		if (ScopedPackageNames.Contains(PackageName) || FailedRedirectorPackageNames.Contains(PackageName))
+		{
+			continue;
+		}
+
+		if (const FAssetData* RedirectorData = KnownRedirectors.Find(PackageName))
+		{
+			InOutRedirectorsData.Add(*RedirectorData);
+			ScopedPackageNames.Add(PackageName);
+		}
+	}
+}
+
+/**
+ * @brief 按引用者包把重定向器分批
+ * 先按最小的引用者包名排序，共享引用者的重定向器相邻，尽量落在同一批里，避免同一个包被反复签出和保存
+ */
+void FRedirectorFixup::BuildFixupBatches(TArray<FAssetData>&& RedirectorsData)
+{
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+
+	struct FRedirectorReferencers
+	{
+		FAssetData RedirectorData;
+		TArray<FName> ReferencerPackageNames;
+	};
+
+	TArray<FRedirectorReferencers> AllReferencers;
+	AllReferencers.Reserve(RedirectorsData.Num());
+
+	for (FAssetData& RedirectorData : RedirectorsData)
+	{
+		FRedirectorReferencers& Referencers = AllReferencers.AddDefaulted_GetRef();
+		AssetRegistry.GetReferencers(RedirectorData.PackageName, Referencers.ReferencerPackageNames, UE::AssetRegistry::EDependencyCategory::Package);
+		Referencers.ReferencerPackageNames.Sort(FNameLexicalLess());
+		Referencers.RedirectorData = MoveTemp(RedirectorData);
+	}
+
+	AllReferencers.StableSort([](const FRedirectorReferencers& A, const FRedirectorReferencers& B)
+	{
+		if (A.ReferencerPackageNames.Num() == 0 || B.ReferencerPackageNames.Num() == 0)
+		{
+			return A.ReferencerPackageNames.Num() < B.ReferencerPackageNames.Num();
+		}
+		return FNameLexicalLess()(A.ReferencerPackageNames[0], B.ReferencerPackageNames[0]);
+	});
+
+	FixupBatches.Reset();
+	TSet<FName> BatchReferencerPackageNames;
+
+	for (FRedirectorReferencers& Referencers : AllReferencers)
+	{
+		int32 NumNewReferencers = 0;
+		for (const FName ReferencerPackageName : Referencers.ReferencerPackageNames)
+		{
+			NumNewReferencers += BatchReferencerPackageNames.Contains(ReferencerPackageName) ? 0 : 1;
+		}
+
+		// 当前批放不下时开始新的一批；引用者特别多的单个重定向器独占一批
+		if (FixupBatches.Num() == 0
+			|| (FixupBatches.Last().RedirectorsData.Num() > 0
+				&& BatchReferencerPackageNames.Num() + NumNewReferencers > MaxReferencerPackagesPerBatch))
+		{
+			FixupBatches.AddDefaulted();
+			BatchReferencerPackageNames.Reset();
+		}
+
+		FFixupBatch& Batch = FixupBatches.Last();
+		for (const FName ReferencerPackageName : Referencers.ReferencerPackageNames)
+		{
+			bool bAlreadyInBatch = false;
+			BatchReferencerPackageNames.Add(ReferencerPackageName, &bAlreadyInBatch);
+			if (!bAlreadyInBatch)
+			{
+				Batch.ReferencerPackageNames.Add(ReferencerPackageName);
+			}
+		}
+		Batch.RedirectorsData.Add(MoveTemp(Referencers.RedirectorData));
+	}
+}
+
+/**
+ * @brief 异步加载下一批重定向器包，全部加载完成后修复这一批
+ */
+void FRedirectorFixup::StartNextBatch()
+{
+	if (bCancelRequested || !FixupBatches.IsValidIndex(CurrentBatchIndex))
+	{
+		Finish();
+		return;
+	}
+
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetText(FText::FromString(FString::Printf(TEXT("Fixing up redirectors (batch %d of %d)..."),
+			CurrentBatchIndex + 1, FixupBatches.Num())));
+	}
+
+	const FFixupBatch& Batch = FixupBatches[CurrentBatchIndex];
+	NumPendingLoads = Batch.RedirectorsData.Num();
+
+	// 一次提交整批的异步加载请求，由异步加载线程成批处理，不阻塞编辑器
+	for (const FAssetData& RedirectorData : Batch.RedirectorsData)
+	{
+		LoadPackageAsync(RedirectorData.PackageName.ToString(),
+			FLoadPackageAsyncDelegate::CreateRaw(this, &FRedirectorFixup::OnRedirectorPackageLoaded, CurrentFixupRunId));
+	}
+}
+
+void FRedirectorFixup::OnRedirectorPackageLoaded(const FName& PackageName, UPackage* LoadedPackage,
+	EAsyncLoadingResult::Type Result, uint32 FixupRunId)
+{
+	if (FixupRunId != CurrentFixupRunId || !bIsRunning)
+	{
+		return;
+	}
+
+	// 回调在刷新异步加载的过程中调用，这里只做计数，修复推迟到下一帧
+	if (--NumPendingLoads == 0 && !ProcessBatchTickerHandle.IsValid())
+	{
+		ProcessBatchTickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateRaw(this, &FRedirectorFixup::ProcessLoadedBatch));
+	}
+}
+
+/**
+ * @brief 在 Ticker 中修复已加载完成的一批，再开始下一批
+ * @return 始终返回 false，只执行一次
+ */
+bool FRedirectorFixup::ProcessLoadedBatch(float DeltaTime)
+{
+	ProcessBatchTickerHandle.Reset();
+
+	if (bIsRunning)
+	{
+		FixUpCurrentBatch();
+		StartNextBatch();
+	}
+	return false;
+}
+
+/**
+ * @brief 一批重定向器包加载完成后，先签出这一批的引用者包，再交给 AssetTools 修复并保存
+ */
+void FRedirectorFixup::FixUpCurrentBatch()
+{
+	const FFixupBatch& Batch = FixupBatches[CurrentBatchIndex];
+
+	// 签出由这里按批完成，FixupReferencers 不再逐个弹出签出对话框
+	ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+	if (SourceControlModule.IsEnabled() && SourceControlModule.GetProvider().IsAvailable())
+	{
+		TArray<FString> ReferencerFilenames;
+		for (const FName ReferencerPackageName : Batch.ReferencerPackageNames)
+		{
+			ReferencerFilenames.Add(USourceControlHelpers::PackageFilename(ReferencerPackageName.ToString()));
+		}
+
+		if (ReferencerFilenames.Num() > 0)
+		{
+			USourceControlHelpers::CheckOutOrAddFiles(ReferencerFilenames, true);
+		}
+	}
+
+	TArray<UObjectRedirector*> RedirectorsToFixArray;
+	for (const FAssetData& RedirectorData : Batch.RedirectorsData)
+	{
+		// 包已经加载，FastGetAsset 只在内存中查找，不会再触发同步加载
+		if (UObjectRedirector* RedirectorToFix = Cast<UObjectRedirector>(RedirectorData.FastGetAsset()))
+		{
+			RedirectorsToFixArray.Add(RedirectorToFix);
+		}
+	}
+
+	if (RedirectorsToFixArray.Num() > 0)
+	{
+		FAssetToolsModule& AssetToolsModule =
+		FModuleManager::Get().LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
+
+		AssetToolsModule.Get().FixupReferencers(RedirectorsToFixArray, false);
+	}
+
+	// 修复成功的重定向器会被删除并从已知列表中移除，仍然存在的记为失败
+	for (const FAssetData& RedirectorData : Batch.RedirectorsData)
+	{
+		if (KnownRedirectors.Contains(RedirectorData.PackageName))
+		{
+			FailedRedirectorPackageNames.Add(RedirectorData.PackageName);
+		}
+	}
+
+	++CurrentBatchIndex;
+	SaveResumeFile();
+}
+
+void FRedirectorFixup::Finish()
+{
+	const bool bCompleted = !bCancelRequested;
+	if (bCompleted)
+	{
+		IFileManager::Get().Delete(*GetResumeFilePath(), false, false, true);
+	}
+
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetText(FText::FromString(bCompleted
+			? FString(TEXT("Redirector fixup finished"))
+			: TEXT("Redirector fixup cancelled, ") + FString::FromInt(FixupBatches.Num() - CurrentBatchIndex) + TEXT(" batches left")));
+		ProgressNotification->SetCompletionState(bCompleted ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+		ProgressNotification->ExpireAndFadeout();
+		ProgressNotification.Reset();
+	}
+
+	FixupBatches.Empty();
+	CurrentBatchIndex = 0;
+	bIsRunning = false;
+	bCancelRequested = false;
+
+	// 回调中可能再次发起修复，先取出回调
+	const FOnFixupCompleted CompletedDelegate = MoveTemp(OnFixupCompleted);
+	OnFixupCompleted.Unbind();
+	if (bCompleted)
+	{
+		CompletedDelegate.ExecuteIfBound();
+	}
+}
+
+FString FRedirectorFixup::GetResumeFilePath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SuperManager") / TEXT("RedirectorFixupResume.txt");
+}
+
+/**
+ * @brief 把尚未修复的重定向器包名写入续做文件，每批完成后更新
+ */
+void FRedirectorFixup::SaveResumeFile() const
+{
+	TArray<FString> RemainingPackageNames;
+	for (int32 BatchIndex = CurrentBatchIndex; BatchIndex < FixupBatches.Num(); ++BatchIndex)
+	{
+		for (const FAssetData& RedirectorData : FixupBatches[BatchIndex].RedirectorsData)
+		{
+			RemainingPackageNames.Add(RedirectorData.PackageName.ToString());
+		}
+	}
+
+	FFileHelper::SaveStringArrayToFile(RemainingPackageNames, *GetResumeFilePath());
+}
@@ -0,0 +1,256 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+
+FAdvanceDeletionListModel::FAdvanceDeletionListModel(TArray<FAssetData>&& InAssetsData)
+	: AssetsData(MoveTemp(InAssetsData))
+	, CheckedBits(false, AssetsData.Num())
+	, RemovedBits(false, AssetsData.Num())
+	, DiskSizeRequestedBits(false, AssetsData.Num())
+{
+	DiskSizes.Init(INDEX_NONE, AssetsData.Num());
+	ResourceSizes.Init(INDEX_NONE, AssetsData.Num());
+}
+
+/**
+ * @brief 生成指向第 Index 个资产的列表项
+ * 列表项与模型共享引用计数（别名构造），不会为每一行单独分配内存
+ * @param Index 资产下标
+ * @return 列表项
+ */
+TSharedPtr<FAssetData> FAdvanceDeletionListModel::MakeItem(int32 Index)
+{
+	return TSharedPtr<FAssetData>(AsShared(), &AssetsData[Index]);
+}
+
+void FAdvanceDeletionListModel::MakeAllItems(TArray<TSharedPtr<FAssetData>>& OutItems)
+{
+	OutItems.Reset(AssetsData.Num());
+	for (int32 Index = 0; Index < AssetsData.Num(); ++Index)
+	{
+		OutItems.Add(MakeItem(Index));
+	}
+}
+
+/**
+ * @brief 由列表项反查资产下标
+ * @param Item 由 MakeItem 生成的列表项
+ * @return 资产下标，不属于本模型时返回 INDEX_NONE
+ */
+int32 FAdvanceDeletionListModel::GetItemIndex(const TSharedPtr<FAssetData>& Item) const
+{
+	if (!Item.IsValid())
+	{
+		return INDEX_NONE;
+	}
+
+	const int32 Index = static_cast<int32>(Item.Get() - AssetsData.GetData());
+	return AssetsData.IsValidIndex(Index) ? Index : INDEX_NONE;
+}
+
+#pragma region CheckState
+
+/**
+ * @brief 批量设置勾选状态，用于全选当前显示的列表项
+ * @param Items 列表项
+ * @param bChecked 是否勾选
+ */
+void FAdvanceDeletionListModel::SetItemsChecked(const TArray<TSharedPtr<FAssetData>>& Items, bool bChecked)
+{
+	for (const TSharedPtr<FAssetData>& Item : Items)
+	{
+		const int32 Index = GetItemIndex(Item);
+		if (Index != INDEX_NONE)
+		{
+			CheckedBits[Index] = bChecked;
+		}
+	}
+}
+
+void FAdvanceDeletionListModel::ClearAllChecked()
+{
+	CheckedBits.SetRange(0, CheckedBits.Num(), false);
+}
+
+void FAdvanceDeletionListModel::GetCheckedIndices(TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset(NumChecked());
+	for (TConstSetBitIterator<> It(CheckedBits); It; ++It)
+	{
+		OutIndices.Add(It.GetIndex());
+	}
+}
+
+void FAdvanceDeletionListModel::GetCheckedAssetsData(TArray<FAssetData>& OutAssetsData) const
+{
+	OutAssetsData.Reset(NumChecked());
+	for (TConstSetBitIterator<> It(CheckedBits); It; ++It)
+	{
+		OutAssetsData.Add(AssetsData[It.GetIndex()]);
+	}
+}
+
+#pragma endregion
+
+#pragma region Removal
+
+void FAdvanceDeletionListModel::MarkRemoved(int32 Index)
+{
+	RemovedBits[Index] = true;
+	CheckedBits[Index] = false;
+}
+
+bool FAdvanceDeletionListModel::IsItemRemoved(const TSharedPtr<FAssetData>& Item) const
+{
+	const int32 Index = GetItemIndex(Item);
+	return Index != INDEX_NONE && RemovedBits[Index];
+}
+
+#pragma endregion
+
+#pragma region AssetSize
+
+/**
+ * @brief 请求统计一个资产的磁盘大小，同一帧内的请求会攒成一批统计
+ * @param Index 资产下标
+ */
+void FAdvanceDeletionListModel::RequestDiskSize(int32 Index)
+{
+	if (!AssetsData.IsValidIndex(Index) || DiskSizeRequestedBits[Index])
+	{
+		return;
+	}
+
+	DiskSizeRequestedBits[Index] = true;
+	PendingDiskSizeIndices.Add(Index);
+
+	// 推迟到本帧生成完所有可见行之后再启动
+	if (!bDiskSizeTaskQueued)
+	{
+		bDiskSizeTaskQueued = true;
+		AsyncTask(ENamedThreads::GameThread, [WeakModel = TWeakPtr<FAdvanceDeletionListModel>(AsShared())]()
+		{
+			if (const TSharedPtr<FAdvanceDeletionListModel> Model = WeakModel.Pin())
+			{
+				Model->StartDiskSizeTask();
+			}
+		});
+	}
+}
+
+void FAdvanceDeletionListModel::RequestDiskSizes(const TArray<TSharedPtr<FAssetData>>& Items)
+{
+	for (const TSharedPtr<FAssetData>& Item : Items)
+	{
+		RequestDiskSize(GetItemIndex(Item));
+	}
+}
+
+/**
+ * @brief 在线程池中统计一批包文件的大小，结果回到游戏线程写入缓存
+ * 统计期间新的请求会排到下一批
+ */
+void FAdvanceDeletionListModel::StartDiskSizeTask()
+{
+	TArray<int32> BatchIndices = MoveTemp(PendingDiskSizeIndices);
+	PendingDiskSizeIndices.Reset();
+
+	TArray<FName> BatchPackageNames;
+	BatchPackageNames.Reserve(BatchIndices.Num());
+	for (const int32 Index : BatchIndices)
+	{
+		BatchPackageNames.Add(AssetsData[Index].PackageName);
+	}
+
+	Async(EAsyncExecution::ThreadPool, [WeakModel = TWeakPtr<FAdvanceDeletionListModel>(AsShared()),
+		BatchIndices = MoveTemp(BatchIndices), BatchPackageNames = MoveTemp(BatchPackageNames)]() mutable
+	{
+		IFileManager& FileManager = IFileManager::Get();
+
+		TArray<int64> BatchDiskSizes;
+		BatchDiskSizes.Reserve(BatchPackageNames.Num());
+		for (const FName PackageName : BatchPackageNames)
+		{
+			// 找不到包文件（如尚未保存的资产）记为 0，不再重复统计
+			FString PackageFilename;
+			const int64 FileSize = FPackageName::DoesPackageExist(PackageName.ToString(), &PackageFilename)
+				? FileManager.FileSize(*PackageFilename) : 0;
+			BatchDiskSizes.Add(FMath::Max<int64>(FileSize, 0));
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakModel, BatchIndices = MoveTemp(BatchIndices), BatchDiskSizes = MoveTemp(BatchDiskSizes)]()
+		{
+			const TSharedPtr<FAdvanceDeletionListModel> Model = WeakModel.Pin();
+			if (!Model.IsValid())
+			{
+				return;
+			}
+
+			for (int32 BatchIndex = 0; BatchIndex < BatchIndices.Num(); ++BatchIndex)
+			{
+				Model->DiskSizes[BatchIndices[BatchIndex]] = BatchDiskSizes[BatchIndex];
+			}
+
+			Model->bDiskSizeTaskQueued = false;
+			if (Model->PendingDiskSizeIndices.Num() > 0)
+			{
+				Model->bDiskSizeTaskQueued = true;
+				Model->StartDiskSizeTask();
+			}
+
+			Model->OnDiskSizesGathered.ExecuteIfBound();
+		});
+	});
+}
+
+/**
+ * @brief 统计勾选资产的磁盘大小之和，即删除后可以回收的空间
+ * @param OutNumUnknown 尚未统计出大小的勾选资产数量
+ * @return 已统计部分的字节数
+ */
+int64 FAdvanceDeletionListModel::GetCheckedDiskSize(int32& OutNumUnknown) const
+{
+	int64 CheckedDiskSize = 0;
+	OutNumUnknown = 0;
+	for (TConstSetBitIterator<> It(CheckedBits); It; ++It)
+	{
+		const int64 DiskSize = DiskSizes[It.GetIndex()];
+		if (DiskSize == INDEX_NONE)
+		{
+			++OutNumUnknown;
+		}
+		else
+		{
+			CheckedDiskSize += DiskSize;
+		}
+	}
+	return CheckedDiskSize;
+}
+
+/**
+ * @brief 取资产的估算资源大小，只统计已经常驻内存的资产，不会为此加载资产
+ * @param Index 资产下标
+ * @return 资源大小，资产未加载时返回 INDEX_NONE
+ */
+int64 FAdvanceDeletionListModel::GetResourceSize(int32 Index) const
+{
+	if (ResourceSizes[Index] != INDEX_NONE)
+	{
+		return ResourceSizes[Index];
+	}
+
+	const UObject* ResidentAsset = AssetsData[Index].FastGetAsset(false);
+	if (!ResidentAsset)
+	{
+		return INDEX_NONE;
+	}
+
+	ResourceSizes[Index] = ResidentAsset->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	return ResourceSizes[Index];
+}
+
+#pragma endregion
@@ -1,13 +1,76 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "SlateWidgets/AdvanceDeletionWidget.h"
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Layout/SWidgetSwitcher.h"
+#include "Widgets/Views/SHeaderRow.h"
 #include "DebugHeader.h"
 #include "SuperManager.h"
-#include "Widgets/Layout/SScrollBox.h"
 
 #define ListAll TEXT("List All Available Assets")
 #define ListUnused TEXT("List Unused Assets")
+#define ListUnreachable TEXT("List Unreachable Assets")
 #define ListSameName TEXT("List Assets With Same Name")
+#define ListIdenticalContent TEXT("List Assets With Identical Content")
+
+namespace
+{
+	/**
+	 * 列表视图的列，分组视图的行按同样的宽度排列
+	 */
+	struct FAssetListColumn
+	{
+		FName ColumnId;
+		const TCHAR* Label;
+		float FillWidth;
+		bool bSortable;
+	};
+
+	const FName CheckBoxColumnId(TEXT("CheckBox"));
+	const FName ClassColumnId(TEXT("Class"));
+	const FName NameColumnId(TEXT("Name"));
+	const FName DiskSizeColumnId(TEXT("DiskSize"));
+	const FName ResourceSizeColumnId(TEXT("ResourceSize"));
+	const FName DeleteColumnId(TEXT("Delete"));
+
+	const FAssetListColumn AssetListColumns[] =
+	{
+		{CheckBoxColumnId,		TEXT(""),				.05f,	false},
+		{ClassColumnId,			TEXT("Class"),			.25f,	true},
+		{NameColumnId,			TEXT("Name"),			.4f,	true},
+		{DiskSizeColumnId,		TEXT("Disk Size"),		.12f,	true},
+		{ResourceSizeColumnId,	TEXT("Resource Size"),	.12f,	true},
+		{DeleteColumnId,		TEXT(""),				.1f,	false},
+	};
+
+	DECLARE_DELEGATE_RetVal_OneParam(TSharedRef<SWidget>, FOnGenerateAssetListCell, const FName& /*ColumnId*/);
+
+	/**
+	 * 列表视图的行，每一列的内容由 Advance Deletion 页面生成
+	 */
+	class SAdvanceDeletionListRow : public SMultiColumnTableRow<TSharedPtr<FAssetData>>
+	{
+	public:
+		SLATE_BEGIN_ARGS(SAdvanceDeletionListRow) {}
+		SLATE_EVENT(FOnGenerateAssetListCell, OnGenerateCell)
+		SLATE_END_ARGS()
+
+		void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& OwnerTable)
+		{
+			OnGenerateCell = InArgs._OnGenerateCell;
+			FSuperRowType::Construct(FSuperRowType::FArguments().Padding(FMargin(3.f)), OwnerTable);
+		}
+
+		virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+		{
+			return OnGenerateCell.Execute(ColumnName);
+		}
+
+	private:
+		FOnGenerateAssetListCell OnGenerateCell;
+	};
+}
 
 /**
  * @brief 窗体构造函数
@@ -17,17 +80,22 @@ void SAdvanceDeletionTab::Construct(const FArguments& InArgs)
 {
 	bCanSupportFocus = true;
 
-	// 接收参数
-	StoredAssetsData = InArgs._AssetsDataToStore;
+	// 接收参数，列表项只是指向模型中连续数组的别名指针
+	AssetListModel = InArgs._AssetListModel;
+	if (AssetListModel.IsValid())
+	{
+		AssetListModel->MakeAllItems(StoredAssetsData);
+		AssetListModel->OnDiskSizesGathered.BindSP(this, &SAdvanceDeletionTab::OnDiskSizesGathered);
+	}
 	DisplayedAssetsData = StoredAssetsData;
 	
-	CheckBoxesArray.Empty();
-	AssetDataToDeleteArray.Empty();
 	ComboBoxSourceItems.Empty();
 
 	ComboBoxSourceItems.Add(MakeShared<FString>(ListAll));
 	ComboBoxSourceItems.Add(MakeShared<FString>(ListUnused));
+	ComboBoxSourceItems.Add(MakeShared<FString>(ListUnreachable));
 	ComboBoxSourceItems.Add(MakeShared<FString>(ListSameName));
+	ComboBoxSourceItems.Add(MakeShared<FString>(ListIdenticalContent));
 
 	FSlateFontInfo TitleTextFont = GetEmbossedTextFont();
 	TitleTextFont.Size = 20;
@@ -73,15 +141,32 @@ void SAdvanceDeletionTab::Construct(const FArguments& InArgs)
 			]
 		]
 
-		// Asset list scroll view
+		// Asset list view
+		// SListView 自带滚动条，不能再套一层 SScrollBox，否则会失去虚拟化，每一行都会被生成
+		// 同名筛选时切换到按名称分组的树视图
 		+SVerticalBox::Slot()
+		.FillHeight(1.f)
 		.VAlign(VAlign_Fill)
 		[
-			SNew(SScrollBox)
-			+SScrollBox::Slot()
+			SAssignNew(AssetViewSwitcher, SWidgetSwitcher)
+			.WidgetIndex(0)
+			+SWidgetSwitcher::Slot()
 			[
 				ConstructAssetListView()
 			]
+			+SWidgetSwitcher::Slot()
+			[
+				ConstructAssetGroupTreeView()
+			]
+		]
+
+		// Selection summary
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(3.f)
+		[
+			SNew(STextBlock)
+			.Text(this, &SAdvanceDeletionTab::GetSelectionSummaryText)
 		]
 
 		// Button group
@@ -123,23 +208,64 @@ TSharedRef<SListView<TSharedPtr<FAssetData>>> SAdvanceDeletionTab::ConstructAsse
 	SNew(SListView<TSharedPtr<FAssetData>>)
 	.ItemHeight(24.f)
 	.ListItemsSource(&DisplayedAssetsData)
+	.HeaderRow(ConstructAssetListHeaderRow())
 	.OnGenerateRow(this, &SAdvanceDeletionTab::OnGenerateRowForList)
 	.OnMouseButtonClick(this, &SAdvanceDeletionTab::OnRowWidgetMouseButtonClicked);
 
 	return ConstructedAssetListView.ToSharedRef();
 }
 
+/**
+ * @brief 从存储和显示的列表中移除已删除的资产
+ * 每个数组只遍历一次，是否已删除由模型按下标判断
+ */
+void SAdvanceDeletionTab::RemoveDeletedItems()
+{
+	auto IsRemoved = [this](const TSharedPtr<FAssetData>& Item)
+	{
+		return AssetListModel->IsItemRemoved(Item);
+	};
+
+	StoredAssetsData.RemoveAll(IsRemoved);
+	DisplayedAssetsData.RemoveAll(IsRemoved);
+
+	// 删除后只剩一个资产的组不再算重复，重新分组
+	if (AssetGroupingMode != EAssetGroupingMode::None)
+	{
+		const TArray<TSharedPtr<FAssetData>> RemainingAssetsData = MoveTemp(DisplayedAssetsData);
+		ListGroupedAssets(RemainingAssetsData);
+	}
+}
+
 /**
  * @brief 刷新资源列表视图
  */
 void SAdvanceDeletionTab::RefreshAssetListView()
 {
-	AssetDataToDeleteArray.Empty();
-	// CheckBoxesArray.Empty();
+	if (AssetListModel.IsValid())
+	{
+		AssetListModel->ClearAllChecked();
+	}
 	
+	// 刷新已有的列表视图，而不是重新构造一个新的
 	if (ConstructedAssetListView.IsValid())
 	{
-		ConstructAssetListView()->RebuildList();
+		ConstructedAssetListView->RequestListRefresh();
+	}
+
+	if (ConstructedAssetGroupTreeView.IsValid())
+	{
+		ConstructedAssetGroupTreeView->RequestTreeRefresh();
+	}
+
+	if (AssetGroupingMode == EAssetGroupingMode::None)
+	{
+		SortDisplayedAssets();
+	}
+
+	if (AssetViewSwitcher.IsValid())
+	{
+		AssetViewSwitcher->SetActiveWidgetIndex(AssetGroupingMode != EAssetGroupingMode::None ? 1 : 0);
 	}
 }
 
@@ -152,83 +278,129 @@ TSharedRef<ITableRow> SAdvanceDeletionTab::OnGenerateRowForList(TSharedPtr<FAsse
 		return SNew(STableRow<TSharedPtr<FAssetData>>, OwnerTable);
 	}
 
-	const FString DisplayAssetClassName = AssetDataToDisplay->GetClass()->ConvertPathNameToShortTypeName(AssetDataToDisplay->AssetClassPath.ToString());
-	const FString DisplayAssetName = AssetDataToDisplay->AssetName.ToString();
+	TSharedRef<SAdvanceDeletionListRow> ListViewRowWidget =
+	SNew(SAdvanceDeletionListRow, OwnerTable)
+	.OnGenerateCell(this, &SAdvanceDeletionTab::ConstructCellForColumn, AssetDataToDisplay);
 
-	FSlateFontInfo AssetClassNameFont = GetEmbossedTextFont();
-	AssetClassNameFont.Size = 10;
+	return ListViewRowWidget;
+}
 
-	FSlateFontInfo AssetNameFont = GetEmbossedTextFont();
-	AssetNameFont.Size = 10;
-	
-	TSharedRef<STableRow<TSharedPtr<FAssetData>>> ListViewRowWidget =
-	SNew(STableRow<TSharedPtr<FAssetData>>, OwnerTable).Padding(FMargin(3.f))
-	[
-		
-		SNew(SHorizontalBox)
+/**
+ * @brief 构建分组视图中一行资产的内容，各列与列表视图的表头等宽
+ * @param AssetDataToDisplay 资产数据
+ * @return 
+ */
+TSharedRef<SWidget> SAdvanceDeletionTab::ConstructRowContent(const TSharedPtr<FAssetData>& AssetDataToDisplay)
+{
+	TSharedRef<SHorizontalBox> RowContent = SNew(SHorizontalBox);
+	for (const FAssetListColumn& Column : AssetListColumns)
+	{
+		RowContent->AddSlot()
+		.FillWidth(Column.FillWidth)
+		[
+			ConstructCellForColumn(Column.ColumnId, AssetDataToDisplay)
+		];
+	}
+
+	return RowContent;
+}
 
-		// Check box
-		+SHorizontalBox::Slot()
+/**
+ * @brief 构建一行中某一列的内容，列表视图和分组视图共用
+ * 只有可见的行会被生成，磁盘大小在这里按需请求统计
+ * @param ColumnId 列
+ * @param AssetDataToDisplay 资产数据
+ * @return 
+ */
+TSharedRef<SWidget> SAdvanceDeletionTab::ConstructCellForColumn(const FName& ColumnId, TSharedPtr<FAssetData> AssetDataToDisplay)
+{
+	FSlateFontInfo RowTextFont = GetEmbossedTextFont();
+	RowTextFont.Size = 10;
+
+	if (ColumnId == CheckBoxColumnId)
+	{
+		return SNew(SBox)
 		.HAlign(HAlign_Left)
 		.VAlign(VAlign_Center)
-		.FillWidth(.05f)
 		[
 			ConstructCheckBox(AssetDataToDisplay)
-		]
+		];
+	}
 
-		// Asset class name
-		+SHorizontalBox::Slot()
-		.HAlign(HAlign_Center)
-		.VAlign(VAlign_Fill)
-		.FillWidth(.5f)
-		[
-			ConstructTextForRowWidget(DisplayAssetClassName, AssetClassNameFont)
-		]
-		
-		// Asset name
-		+SHorizontalBox::Slot()
-		.HAlign(HAlign_Left)
-		.VAlign(VAlign_Fill)
-		[
-			ConstructTextForRowWidget(DisplayAssetName, AssetNameFont)
-		]
+	if (ColumnId == ClassColumnId)
+	{
+		// 类名直接取自 AssetClassPath，不需要查找 UClass
+		return ConstructTextForRowWidget(AssetDataToDisplay->AssetClassPath.GetAssetName().ToString(), RowTextFont);
+	}
+
+	if (ColumnId == NameColumnId)
+	{
+		return ConstructTextForRowWidget(AssetDataToDisplay->AssetName.ToString(), RowTextFont);
+	}
+
+	if (ColumnId == DiskSizeColumnId || ColumnId == ResourceSizeColumnId)
+	{
+		if (ColumnId == DiskSizeColumnId && AssetListModel.IsValid())
+		{
+			AssetListModel->RequestDiskSize(AssetListModel->GetItemIndex(AssetDataToDisplay));
+		}
+
+		return SNew(STextBlock)
+		.Text(this, ColumnId == DiskSizeColumnId ? &SAdvanceDeletionTab::GetDiskSizeText : &SAdvanceDeletionTab::GetResourceSizeText,
+			AssetDataToDisplay)
+		.Font(RowTextFont)
+		.ColorAndOpacity(FColor::White);
+	}
 
-		// Button
-		+SHorizontalBox::Slot()
+	if (ColumnId == DeleteColumnId)
+	{
+		return SNew(SBox)
 		.HAlign(HAlign_Right)
-		.VAlign(VAlign_Fill)
 		[
 			ConstructButtonForRowWidget(AssetDataToDisplay)
-		]
-	];
+		];
+	}
 
-	return ListViewRowWidget;
+	return SNullWidget::NullWidget;
 }
 
 TSharedRef<SCheckBox> SAdvanceDeletionTab::ConstructCheckBox(const TSharedPtr<FAssetData>& AssetDataToDisplay)
 {
+	// 勾选状态绑定到模型，行控件被回收或重新生成时不会丢失
 	TSharedRef<SCheckBox> ConstructedCheckBox = SNew(SCheckBox)
 	.Type(ESlateCheckBoxType::CheckBox)
 	.Visibility(EVisibility::Visible)
+	.IsChecked(this, &SAdvanceDeletionTab::GetCheckBoxState, AssetDataToDisplay)
 	.OnCheckStateChanged(this, &SAdvanceDeletionTab::OnCheckBoxStateChanged, AssetDataToDisplay);
-
-	CheckBoxesArray.Add(ConstructedCheckBox);
 	
 	return ConstructedCheckBox;
 }
 
+ECheckBoxState SAdvanceDeletionTab::GetCheckBoxState(TSharedPtr<FAssetData> AssetData) const
+{
+	const int32 Index = AssetListModel.IsValid() ? AssetListModel->GetItemIndex(AssetData) : INDEX_NONE;
+	if (Index == INDEX_NONE)
+	{
+		return ECheckBoxState::Unchecked;
+	}
+	return AssetListModel->IsChecked(Index) ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
 void SAdvanceDeletionTab::OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FAssetData> AssetData)
 {
+	const int32 Index = AssetListModel.IsValid() ? AssetListModel->GetItemIndex(AssetData) : INDEX_NONE;
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
 	switch (NewState)
 	{
 	case ECheckBoxState::Unchecked:
-		if (AssetDataToDeleteArray.Contains(AssetData))
-		{
-			AssetDataToDeleteArray.Remove(AssetData);
-		}
+		AssetListModel->SetChecked(Index, false);
 		break;
 	case ECheckBoxState::Checked:
-		AssetDataToDeleteArray.AddUnique(AssetData);
+		AssetListModel->SetChecked(Index, true);
 		break;
 	case ECheckBoxState::Undetermined: break;
 	default: ;
@@ -261,22 +433,16 @@ FReply SAdvanceDeletionTab::OnDeleteButtonClicked(TSharedPtr<FAssetData> Clicked
 	FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
 
 	// 将 TSharedPtr<FAssetData> 解引用为 FAssetData&
-	const bool bAssetDeleted =
-	SuperManagerModule.DeleteSingleAssetForAssetList(*ClickedAssetData.Get());
+	const TArray<EAssetDeletionResult> DeletionResults =
+	SuperManagerModule.DeleteAssetsForAssetList({*ClickedAssetData.Get()});
+	const bool bAssetDeleted = DeletionResults[0] == EAssetDeletionResult::Deleted;
 
 	// 刷新列表
-	if (bAssetDeleted)
+	const int32 ClickedIndex = AssetListModel.IsValid() ? AssetListModel->GetItemIndex(ClickedAssetData) : INDEX_NONE;
+	if (bAssetDeleted && ClickedIndex != INDEX_NONE)
 	{
-		if (StoredAssetsData.Contains(ClickedAssetData))
-		{
-			StoredAssetsData.Remove(ClickedAssetData);
-		}
-
-		if (DisplayedAssetsData.Contains(ClickedAssetData))
-		{
-			DisplayedAssetsData.Remove(ClickedAssetData);
-		}
-		
+		AssetListModel->MarkRemoved(ClickedIndex);
+		RemoveDeletedItems();
 		RefreshAssetListView();
 	}
 	
@@ -294,6 +460,312 @@ void SAdvanceDeletionTab::OnRowWidgetMouseButtonClicked(TSharedPtr<FAssetData> C
 #pragma endregion
 
 
+#pragma region AssetListColumns
+
+TSharedRef<SHeaderRow> SAdvanceDeletionTab::ConstructAssetListHeaderRow()
+{
+	TSharedRef<SHeaderRow> HeaderRow = SNew(SHeaderRow);
+	for (const FAssetListColumn& Column : AssetListColumns)
+	{
+		SHeaderRow::FColumn::FArguments ColumnArgs;
+		ColumnArgs
+		.ColumnId(Column.ColumnId)
+		.DefaultLabel(FText::FromString(Column.Label))
+		.FillWidth(Column.FillWidth);
+
+		if (Column.bSortable)
+		{
+			ColumnArgs
+			.SortMode(this, &SAdvanceDeletionTab::GetColumnSortMode, Column.ColumnId)
+			.OnSort(this, &SAdvanceDeletionTab::OnColumnSortModeChanged);
+		}
+
+		HeaderRow->AddColumn(ColumnArgs);
+	}
+
+	return HeaderRow;
+}
+
+EColumnSortMode::Type SAdvanceDeletionTab::GetColumnSortMode(FName ColumnId) const
+{
+	return ColumnId == SortColumnId ? SortMode : EColumnSortMode::None;
+}
+
+void SAdvanceDeletionTab::OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId,
+	EColumnSortMode::Type InSortMode)
+{
+	SortColumnId = ColumnId;
+	SortMode = InSortMode;
+
+	// 按磁盘大小排序需要所有显示资产的大小，统计完成后会再排序一次
+	if (SortColumnId == DiskSizeColumnId && AssetListModel.IsValid())
+	{
+		AssetListModel->RequestDiskSizes(DisplayedAssetsData);
+	}
+
+	SortDisplayedAssets();
+	if (ConstructedAssetListView.IsValid())
+	{
+		ConstructedAssetListView->RequestListRefresh();
+	}
+}
+
+/**
+ * @brief 按当前的排序列对列表视图中的资产做稳定排序
+ * 大小列的排序键先按模型下标取出一次，比较时不再重复查询；尚未统计出大小的资产排在最小的位置
+ */
+void SAdvanceDeletionTab::SortDisplayedAssets()
+{
+	if (SortMode == EColumnSortMode::None || SortColumnId.IsNone() || !AssetListModel.IsValid())
+	{
+		return;
+	}
+
+	const bool bAscending = SortMode == EColumnSortMode::Ascending;
+
+	if (SortColumnId == ClassColumnId || SortColumnId == NameColumnId)
+	{
+		const bool bSortByClass = SortColumnId == ClassColumnId;
+		DisplayedAssetsData.StableSort([bAscending, bSortByClass](const TSharedPtr<FAssetData>& A, const TSharedPtr<FAssetData>& B)
+		{
+			const int32 Comparison = bSortByClass
+				? A->AssetClassPath.GetAssetName().Compare(B->AssetClassPath.GetAssetName())
+				: A->AssetName.Compare(B->AssetName);
+			return bAscending ? Comparison < 0 : Comparison > 0;
+		});
+		return;
+	}
+
+	TArray<int64> SortKeys;
+	SortKeys.Init(INDEX_NONE, AssetListModel->Num());
+	for (const TSharedPtr<FAssetData>& Item : DisplayedAssetsData)
+	{
+		const int32 Index = AssetListModel->GetItemIndex(Item);
+		SortKeys[Index] = SortColumnId == DiskSizeColumnId ? AssetListModel->GetDiskSize(Index) : AssetListModel->GetResourceSize(Index);
+	}
+
+	DisplayedAssetsData.StableSort([this, bAscending, &SortKeys](const TSharedPtr<FAssetData>& A, const TSharedPtr<FAssetData>& B)
+	{
+		const int64 KeyA = SortKeys[AssetListModel->GetItemIndex(A)];
+		const int64 KeyB = SortKeys[AssetListModel->GetItemIndex(B)];
+		return bAscending ? KeyA < KeyB : KeyA > KeyB;
+	});
+}
+
+void SAdvanceDeletionTab::OnDiskSizesGathered()
+{
+	if (SortColumnId == DiskSizeColumnId && AssetGroupingMode == EAssetGroupingMode::None)
+	{
+		SortDisplayedAssets();
+		if (ConstructedAssetListView.IsValid())
+		{
+			ConstructedAssetListView->RequestListRefresh();
+		}
+	}
+}
+
+FText SAdvanceDeletionTab::GetDiskSizeText(TSharedPtr<FAssetData> AssetData) const
+{
+	const int32 Index = AssetListModel.IsValid() ? AssetListModel->GetItemIndex(AssetData) : INDEX_NONE;
+	if (Index == INDEX_NONE || !AssetListModel->HasDiskSize(Index))
+	{
+		return FText::FromString(TEXT("..."));
+	}
+	return FText::AsMemory(AssetListModel->GetDiskSize(Index));
+}
+
+FText SAdvanceDeletionTab::GetResourceSizeText(TSharedPtr<FAssetData> AssetData) const
+{
+	const int32 Index = AssetListModel.IsValid() ? AssetListModel->GetItemIndex(AssetData) : INDEX_NONE;
+	const int64 ResourceSize = Index != INDEX_NONE ? AssetListModel->GetResourceSize(Index) : INDEX_NONE;
+	if (ResourceSize == INDEX_NONE)
+	{
+		return FText::FromString(TEXT("Not Loaded"));
+	}
+	return FText::AsMemory(ResourceSize);
+}
+
+/**
+ * @brief 勾选资产的数量和删除后可回收的磁盘空间
+ */
+FText SAdvanceDeletionTab::GetSelectionSummaryText() const
+{
+	if (!AssetListModel.IsValid() || AssetListModel->NumChecked() == 0)
+	{
+		return FText::FromString(TEXT("No asset selected"));
+	}
+
+	int32 NumUnknown = 0;
+	const int64 ReclaimableBytes = AssetListModel->GetCheckedDiskSize(NumUnknown);
+
+	FString SummaryText = FString::Printf(TEXT("%d selected, %s reclaimable"), AssetListModel->NumChecked(),
+		*FText::AsMemory(ReclaimableBytes).ToString());
+	if (NumUnknown > 0)
+	{
+		SummaryText += FString::Printf(TEXT(" (calculating %d more...)"), NumUnknown);
+	}
+	return FText::FromString(SummaryText);
+}
+
+#pragma endregion
+
+
+#pragma region AssetGroupView
+
+TSharedRef<STreeView<TSharedPtr<FAssetGroupTreeItem>>> SAdvanceDeletionTab::ConstructAssetGroupTreeView()
+{
+	ConstructedAssetGroupTreeView =
+	SNew(STreeView<TSharedPtr<FAssetGroupTreeItem>>)
+	.ItemHeight(24.f)
+	.TreeItemsSource(&AssetGroupTreeRootItems)
+	.OnGenerateRow(this, &SAdvanceDeletionTab::OnGenerateRowForAssetGroupTree)
+	.OnGetChildren(this, &SAdvanceDeletionTab::OnGetAssetGroupTreeChildren)
+	.OnMouseButtonClick(this, &SAdvanceDeletionTab::OnAssetGroupTreeMouseButtonClicked);
+
+	return ConstructedAssetGroupTreeView.ToSharedRef();
+}
+
+/**
+ * @brief 按当前的分组方式筛选资产，显示列表保存分组后的结果，供全选和删除使用
+ * 内容比较需要读取包文件，在后台进行，完成前列表为空，期间切换了分组方式或再次请求时结果被丢弃
+ * @param AssetDataToFilter 待筛选的资产，不能是 DisplayedAssetsData 本身
+ */
+void SAdvanceDeletionTab::ListGroupedAssets(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter)
+{
+	FSuperManagerModule& SuperManagerModule =
+		FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
+
+	switch (AssetGroupingMode)
+	{
+	case EAssetGroupingMode::SameName:
+		SuperManagerModule.ListSameNameAssetsForAssetList(AssetDataToFilter, DisplayedAssetsData, AssetGroups);
+		break;
+	case EAssetGroupingMode::IdenticalContent:
+		DisplayedAssetsData.Reset();
+		AssetGroups.Reset();
+		SuperManagerModule.ListIdenticalContentAssetsForAssetListAsync(AssetDataToFilter,
+			[WeakTab = TWeakPtr<SAdvanceDeletionTab>(SharedThis(this)), RequestId = ++IdenticalContentRequestId]
+			(TArray<TSharedPtr<FAssetData>>&& IdenticalAssetsData, TArray<FAssetDataGroup>&& IdenticalAssetGroups)
+			{
+				const TSharedPtr<SAdvanceDeletionTab> Tab = WeakTab.Pin();
+				if (!Tab.IsValid() || Tab->AssetGroupingMode != EAssetGroupingMode::IdenticalContent
+					|| Tab->IdenticalContentRequestId != RequestId)
+				{
+					return;
+				}
+
+				Tab->DisplayedAssetsData = MoveTemp(IdenticalAssetsData);
+				Tab->AssetGroups = MoveTemp(IdenticalAssetGroups);
+				Tab->RebuildAssetGroupTreeItems();
+				Tab->RefreshAssetListView();
+			});
+		break;
+	case EAssetGroupingMode::None:
+	default:
+		DisplayedAssetsData = AssetDataToFilter;
+		AssetGroups.Reset();
+		break;
+	}
+	
+	RebuildAssetGroupTreeItems();
+}
+
+/**
+ * @brief 由分组区间生成树节点，每组一个组头，组内资产作为子节点，默认展开
+ * 展开状态按当前的节点重新建立：被用户折叠的组按组名保持折叠，旧节点不再留在树的展开集合中
+ */
+void SAdvanceDeletionTab::RebuildAssetGroupTreeItems()
+{
+	TSet<FName> CollapsedGroupNames;
+	if (ConstructedAssetGroupTreeView.IsValid())
+	{
+		for (const TSharedPtr<FAssetGroupTreeItem>& OldGroupItem : AssetGroupTreeRootItems)
+		{
+			if (!ConstructedAssetGroupTreeView->IsItemExpanded(OldGroupItem))
+			{
+				CollapsedGroupNames.Add(OldGroupItem->GroupName);
+			}
+		}
+		ConstructedAssetGroupTreeView->ClearExpandedItems();
+	}
+
+	AssetGroupTreeRootItems.Reset(AssetGroups.Num());
+
+	for (int32 GroupIndex = 0; GroupIndex < AssetGroups.Num(); ++GroupIndex)
+	{
+		const FAssetDataGroup& Group = AssetGroups[GroupIndex];
+
+		TSharedPtr<FAssetGroupTreeItem> GroupItem = MakeShared<FAssetGroupTreeItem>();
+		GroupItem->GroupIndex = GroupIndex;
+		GroupItem->GroupName = Group.GroupName;
+		GroupItem->Children.Reserve(Group.Num);
+
+		for (int32 AssetIndex = Group.StartIndex; AssetIndex < Group.StartIndex + Group.Num; ++AssetIndex)
+		{
+			TSharedPtr<FAssetGroupTreeItem> ChildItem = MakeShared<FAssetGroupTreeItem>();
+			ChildItem->GroupIndex = GroupIndex;
+			ChildItem->AssetData = DisplayedAssetsData[AssetIndex];
+			GroupItem->Children.Add(ChildItem);
+		}
+
+		AssetGroupTreeRootItems.Add(GroupItem);
+
+		if (ConstructedAssetGroupTreeView.IsValid())
+		{
+			ConstructedAssetGroupTreeView->SetItemExpansion(GroupItem, !CollapsedGroupNames.Contains(Group.GroupName));
+		}
+	}
+}
+
+TSharedRef<ITableRow> SAdvanceDeletionTab::OnGenerateRowForAssetGroupTree(TSharedPtr<FAssetGroupTreeItem> Item,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	if (!Item.IsValid() || !AssetGroups.IsValidIndex(Item->GroupIndex))
+	{
+		return SNew(STableRow<TSharedPtr<FAssetGroupTreeItem>>, OwnerTable);
+	}
+
+	// 子节点与列表视图的行内容相同
+	if (Item->AssetData.IsValid())
+	{
+		return SNew(STableRow<TSharedPtr<FAssetGroupTreeItem>>, OwnerTable).Padding(FMargin(3.f))
+		[
+			ConstructRowContent(Item->AssetData)
+		];
+	}
+
+	// 组头显示名称和组内资产数量
+	const FAssetDataGroup& Group = AssetGroups[Item->GroupIndex];
+
+	FSlateFontInfo GroupNameFont = GetEmbossedTextFont();
+	GroupNameFont.Size = 12;
+
+	return SNew(STableRow<TSharedPtr<FAssetGroupTreeItem>>, OwnerTable).Padding(FMargin(3.f))
+	[
+		ConstructTextForRowWidget(FString::Printf(TEXT("%s (%d)"), *Group.GroupName.ToString(), Group.Num), GroupNameFont)
+	];
+}
+
+void SAdvanceDeletionTab::OnGetAssetGroupTreeChildren(TSharedPtr<FAssetGroupTreeItem> Item,
+	TArray<TSharedPtr<FAssetGroupTreeItem>>& OutChildren)
+{
+	if (Item.IsValid())
+	{
+		OutChildren = Item->Children;
+	}
+}
+
+void SAdvanceDeletionTab::OnAssetGroupTreeMouseButtonClicked(TSharedPtr<FAssetGroupTreeItem> ClickedItem)
+{
+	if (ClickedItem.IsValid() && ClickedItem->AssetData.IsValid())
+	{
+		OnRowWidgetMouseButtonClicked(ClickedItem->AssetData);
+	}
+}
+
+#pragma endregion
+
+
 #pragma region TabButtons
 
 TSharedRef<SButton> SAdvanceDeletionTab::ConstructDeleteAllButton()
@@ -334,38 +806,46 @@ TSharedRef<SButton> SAdvanceDeletionTab::ConstructDeselectAllButton()
 
 FReply SAdvanceDeletionTab::OnDeleteAllButtonClicked()
 {
-	if (AssetDataToDeleteArray.Num() == 0)
+	if (!AssetListModel.IsValid() || AssetListModel->NumChecked() == 0)
 	{
 		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No asset currently selected"));
 		return FReply::Handled();
 	}
 
+	TArray<int32> CheckedIndices;
+	AssetListModel->GetCheckedIndices(CheckedIndices);
+
 	TArray<FAssetData> AssetDataToDelete;
-	for (const TSharedPtr<FAssetData>& Data : AssetDataToDeleteArray)
-	{
-		AssetDataToDelete.Add(*Data.Get());
-	}
+	AssetListModel->GetCheckedAssetsData(AssetDataToDelete);
 
 	FSuperManagerModule& SuperManagerModule =
 	FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
 
-	bool bAssetsDeleted = SuperManagerModule.DeleteMultipleAssetsForAssetList(AssetDataToDelete);
-	if (bAssetsDeleted)
+	// 结果与勾选的下标一一对应，只移除确实删除成功的项
+	const TArray<EAssetDeletionResult> DeletionResults = SuperManagerModule.DeleteAssetsForAssetList(AssetDataToDelete);
+
+	int32 NumOfAssetsDeleted = 0;
+	for (int32 ResultIndex = 0; ResultIndex < DeletionResults.Num(); ++ResultIndex)
 	{
-		for (const TSharedPtr<FAssetData>& DeletedData : AssetDataToDeleteArray)
+		if (DeletionResults[ResultIndex] == EAssetDeletionResult::Deleted)
 		{
-			if (StoredAssetsData.Contains(DeletedData))
-			{
-				StoredAssetsData.Remove(DeletedData);
-			}
-
-			if (DisplayedAssetsData.Contains(DeletedData))
-			{
-				DisplayedAssetsData.Remove(DeletedData);
-			}
+			AssetListModel->MarkRemoved(CheckedIndices[ResultIndex]);
+			++NumOfAssetsDeleted;
 		}
 	}
 
+	if (NumOfAssetsDeleted > 0)
+	{
+		RemoveDeletedItems();
+	}
+
+	const int32 NumOfAssetsFailed = DeletionResults.Num() - NumOfAssetsDeleted
+		- FAssetDeletionService::CountResults(DeletionResults, EAssetDeletionResult::Cancelled);
+	if (NumOfAssetsFailed > 0)
+	{
+		Debug::ShowNotifyInfo(FString::FromInt(NumOfAssetsFailed) + TEXT(" assets were not deleted"));
+	}
+
 	RefreshAssetListView();
 	
 	return FReply::Handled();
@@ -373,17 +853,13 @@ FReply SAdvanceDeletionTab::OnDeleteAllButtonClicked()
 
 FReply SAdvanceDeletionTab::OnSelectAllButtonClicked()
 {
-	if (CheckBoxesArray.Num() == 0)
+	// 只修改模型，可见的复选框通过 IsChecked 绑定自动更新
+	if (AssetListModel.IsValid())
 	{
-		return FReply::Handled();
-	}
+		AssetListModel->SetItemsChecked(DisplayedAssetsData, true);
 
-	for (const TSharedRef<SCheckBox>& CheckBox : CheckBoxesArray)
-	{
-		if (!CheckBox->IsChecked())
-		{
-			CheckBox->ToggleCheckedState();
-		}
+		// 可回收空间需要所有勾选资产的磁盘大小，不可见的行也要统计
+		AssetListModel->RequestDiskSizes(DisplayedAssetsData);
 	}
 	
 	return FReply::Handled();
@@ -391,17 +867,9 @@ FReply SAdvanceDeletionTab::OnSelectAllButtonClicked()
 
 FReply SAdvanceDeletionTab::OnDeselectAllButtonClicked()
 {
-	if (CheckBoxesArray.Num() == 0)
+	if (AssetListModel.IsValid())
 	{
-		return FReply::Handled();
-	}
-
-	for (const TSharedRef<SCheckBox>& CheckBox : CheckBoxesArray)
-	{
-		if (CheckBox->IsChecked())
-		{
-			CheckBox->ToggleCheckedState();
-		}
+		AssetListModel->ClearAllChecked();
 	}
 	
 	return FReply::Handled();
@@ -462,6 +930,8 @@ void SAdvanceDeletionTab::OnComboSelectionChanged(TSharedPtr<FString> SelectedOp
 	FSuperManagerModule& SuperManagerModule =
 		FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
 	
+	AssetGroupingMode = EAssetGroupingMode::None;
+	
 	if (*SelectedOption.Get() == ListAll)
 	{
 		DisplayedAssetsData = StoredAssetsData;
@@ -472,9 +942,21 @@ void SAdvanceDeletionTab::OnComboSelectionChanged(TSharedPtr<FString> SelectedOp
 		SuperManagerModule.ListUnusedAssetsForAssetList(StoredAssetsData, DisplayedAssetsData);
 		RefreshAssetListView();
 	}
+	else if(*SelectedOption.Get() == ListUnreachable)
+	{
+		SuperManagerModule.ListUnreachableAssetsForAssetList(StoredAssetsData, DisplayedAssetsData);
+		RefreshAssetListView();
+	}
 	else if(*SelectedOption.Get() == ListSameName)
 	{
-		SuperManagerModule.ListSameNameAssetsForAssetList(StoredAssetsData, DisplayedAssetsData);
+		AssetGroupingMode = EAssetGroupingMode::SameName;
+		ListGroupedAssets(StoredAssetsData);
+		RefreshAssetListView();
+	}
+	else if(*SelectedOption.Get() == ListIdenticalContent)
+	{
+		AssetGroupingMode = EAssetGroupingMode::IdenticalContent;
+		ListGroupedAssets(StoredAssetsData);
 		RefreshAssetListView();
 	}
 }
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SlateWidgets/FolderListConfirmDialog.h"
+
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Docking/TabManager.h"
+#include "Widgets/SWindow.h"
+#include "Widgets/Views/SListView.h"
+
+void SFolderListConfirmDialog::Construct(const FArguments& InArgs)
+{
+	FolderPaths = InArgs._FolderPaths;
+	ParentWindow = InArgs._ParentWindow;
+
+	// 列表项只是指向 FolderPaths 元素的别名指针，不为每一行单独分配内存
+	FolderPathItems.Reserve(FolderPaths.Num());
+	for (FName& FolderPath : FolderPaths)
+	{
+		FolderPathItems.Add(TSharedPtr<FName>(AsShared(), &FolderPath));
+	}
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+
+		// Message
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(5.f)
+		[
+			SNew(STextBlock)
+			.Text(FText::FromString(InArgs._Message))
+			.AutoWrapText(true)
+		]
+
+		// Folder list
+		+SVerticalBox::Slot()
+		.FillHeight(1.f)
+		.Padding(5.f)
+		[
+			SNew(SListView<TSharedPtr<FName>>)
+			.ItemHeight(20.f)
+			.ListItemsSource(&FolderPathItems)
+			.SelectionMode(ESelectionMode::None)
+			.OnGenerateRow(this, &SFolderListConfirmDialog::OnGenerateRowForFolderList)
+		]
+
+		// Buttons
+		+SVerticalBox::Slot()
+		.AutoHeight()
+		.HAlign(HAlign_Right)
+		.Padding(5.f)
+		[
+			SNew(SHorizontalBox)
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(3.f)
+			[
+				SNew(SButton)
+				.ContentPadding(FMargin(5.f))
+				.Text(FText::FromString(TEXT("Delete All")))
+				.OnClicked(this, &SFolderListConfirmDialog::OnConfirmButtonClicked)
+			]
+
+			+SHorizontalBox::Slot()
+			.AutoWidth()
+			.Padding(3.f)
+			[
+				SNew(SButton)
+				.ContentPadding(FMargin(5.f))
+				.Text(FText::FromString(TEXT("Cancel")))
+				.OnClicked(this, &SFolderListConfirmDialog::OnCancelButtonClicked)
+			]
+		]
+	];
+}
+
+/**
+ * @brief 弹出模态对话框，等待用户确认
+ * @param Title 窗口标题
+ * @param Message 列表上方的提示信息
+ * @param FolderPaths 要列出的文件夹
+ * @return 用户点击确认时返回 true
+ */
+bool SFolderListConfirmDialog::ShowModal(const FString& Title, const FString& Message, TArray<FName>&& FolderPaths)
+{
+	TSharedRef<SWindow> DialogWindow = SNew(SWindow)
+	.Title(FText::FromString(Title))
+	.ClientSize(FVector2D(600.f, 500.f))
+	.SupportsMinimize(false)
+	.SupportsMaximize(false);
+
+	TSharedRef<SFolderListConfirmDialog> Dialog = SNew(SFolderListConfirmDialog)
+	.Message(Message)
+	.FolderPaths(MoveTemp(FolderPaths))
+	.ParentWindow(DialogWindow);
+
+	DialogWindow->SetContent(Dialog);
+
+	FSlateApplication::Get().AddModalWindow(DialogWindow, FGlobalTabmanager::Get()->GetRootWindow());
+
+	return Dialog->IsConfirmed();
+}
+
+TSharedRef<ITableRow> SFolderListConfirmDialog::OnGenerateRowForFolderList(TSharedPtr<FName> FolderPath,
+	const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(STableRow<TSharedPtr<FName>>, OwnerTable).Padding(FMargin(2.f))
+	[
+		SNew(STextBlock)
+		.Text(FText::FromName(*FolderPath))
+	];
+}
+
+FReply SFolderListConfirmDialog::OnConfirmButtonClicked()
+{
+	bConfirmed = true;
+	if (TSharedPtr<SWindow> PinnedWindow = ParentWindow.Pin())
+	{
+		PinnedWindow->RequestDestroyWindow();
+	}
+	return FReply::Handled();
+}
+
+FReply SFolderListConfirmDialog::OnCancelButtonClicked()
+{
+	bConfirmed = false;
+	if (TSharedPtr<SWindow> PinnedWindow = ParentWindow.Pin())
+	{
+		PinnedWindow->RequestDestroyWindow();
+	}
+	return FReply::Handled();
+}
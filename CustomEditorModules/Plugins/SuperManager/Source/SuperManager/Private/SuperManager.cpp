@@ -1,23 +1,90 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SuperManager.h"
-#include "AssetToolsModule.h"
 #include "ContentBrowserModule.h"
 #include "DebugHeader.h"
 #include "EditorAssetLibrary.h"
-#include "ObjectTools.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/AssetManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/PackageName.h"
+#include "Misc/PathViews.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopedSlowTask.h"
+#include "UnusedAssetScanTask.h"
+#include "SlateWidgets/AdvanceDeletionListModel.h"
 #include "SlateWidgets/AdvanceDeletionWidget.h"
+#include "SlateWidgets/FolderListConfirmDialog.h"
 #include "CustomStyle/SuperManagerStyle.h"
 
 #define LOCTEXT_NAMESPACE "FSuperManagerModule"
 
+namespace
+{
+	/**
+	 * @brief 由近及远访问文件夹的祖先路径，只访问名称表中已存在的路径
+	 * @param Visitor 返回 false 时停止
+	 */
+	void ForEachAncestorPath(FName FolderPath, TFunctionRef<bool(FName AncestorPath)> Visitor)
+	{
+		FNameBuilder FolderPathBuilder(FolderPath);
+		FStringView FolderPathView = FolderPathBuilder.ToView();
+
+		int32 SlashIndex;
+		while (FolderPathView.FindLastChar(TEXT('/'), SlashIndex) && SlashIndex > 0)
+		{
+			FolderPathView.LeftInline(SlashIndex);
+
+			const FName AncestorPath(FolderPathView, FNAME_Find);
+			if (AncestorPath.IsNone() || !Visitor(AncestorPath))
+			{
+				return;
+			}
+		}
+	}
+
+	/**
+	 * @brief 磁盘上的目录树中是否有包文件，注册表认为是空的文件夹在删除前用它再次确认
+	 * @param Directory 磁盘目录
+	 */
+	bool DirectoryContainsPackageFiles(const FString& Directory)
+	{
+		bool bContainsPackageFiles = false;
+		FPlatformFileManager::Get().GetPlatformFile().IterateDirectoryRecursively(*Directory,
+			[&bContainsPackageFiles](const TCHAR* FilenameOrDirectory, bool bIsDirectory)
+			{
+				if (!bIsDirectory)
+				{
+					const FString Extension = FPaths::GetExtension(FilenameOrDirectory, true);
+					bContainsPackageFiles = Extension == FPackageName::GetAssetPackageExtension()
+						|| Extension == FPackageName::GetMapPackageExtension();
+				}
+				return !bContainsPackageFiles;
+			});
+
+		return bContainsPackageFiles;
+	}
+}
+
 void FSuperManagerModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	FSuperManagerStyle::InitializeIcons();
+	PathExclusionMatcher.LoadFromPluginConfig();
+	AssetReachabilityRoots.LoadFromPluginConfig();
 	InitCBMenuExtention();
 	RegisterAdvanceDeletionTab();
+	RegisterAssetRegistryEvents();
+
+	// 模块卸载时注册表可能已经关闭，在退出前保存快照
+	PreExitDelegateHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FSuperManagerModule::SaveAssetReferenceIndexSnapshot);
+	if (!IAssetRegistry::GetChecked().IsLoadingAssets())
+	{
+		StartLoadingAssetReferenceIndexSnapshot();
+	}
 }
 
 #pragma region ContentBrowserMenuExtention
@@ -92,9 +159,20 @@ void FSuperManagerModule::OnDeleteUnusedAssetsButtonClicked()
 		return;
 	}
 
-	// 使用 UEditorAssetLibrary::ListAssets 方法获取所选目录下的资产的路径
-	TArray<FString> AssetsPathNames = UEditorAssetLibrary::ListAssets(FolderPathsSelected[0]);
-	if (AssetsPathNames.Num() == 0)
+	if (UnusedAssetScanTask.IsValid() && UnusedAssetScanTask->IsRunning())
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("An unused asset scan is already running"), false);
+		return;
+	}
+
+	// 在游戏线程一次性从注册表取出所选目录下的资产数据，逐个资产的检查放到后台线程
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	Filter.PackagePaths.Add(FName(*FolderPathsSelected[0]));
+
+	TArray<FAssetData> AssetsDataToScan;
+	IAssetRegistry::GetChecked().GetAssets(Filter, AssetsDataToScan);
+	if (AssetsDataToScan.Num() == 0)
 	{
 		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No asset found under selected folder"), false);
 		return;
@@ -102,149 +180,294 @@ void FSuperManagerModule::OnDeleteUnusedAssetsButtonClicked()
 
 	const EAppReturnType::Type ConfirmResult =
 	Debug::ShowMsgDialog(EAppMsgType::YesNo,
-		TEXT("A total of ") + FString::FromInt(AssetsPathNames.Num()) + TEXT(" assets need to be checked.\nWould you like to procceed?"), false);
+		TEXT("A total of ") + FString::FromInt(AssetsDataToScan.Num()) + TEXT(" assets need to be checked.\nWould you like to procceed?"), false);
 
 	if (ConfirmResult == EAppReturnType::No)
 	{
 		return;
 	}
 
-	FixUpRedirectors();
+	// 只修复与所选目录相关的重定向器，修复完成后再开始扫描
+	RedirectorFixup.FixUpRedirectorsInPaths(FolderPathsSelected,
+		FRedirectorFixup::FOnFixupCompleted::CreateLambda([this, AssetsDataToScan = MoveTemp(AssetsDataToScan)]() mutable
+		{
+			StartUnusedAssetScan(MoveTemp(AssetsDataToScan));
+		}));
+}
 
-	TArray<FAssetData> UnusedAssetsDataArray;
-	for (const FString& AssetPathName : AssetsPathNames)
+void FSuperManagerModule::StartUnusedAssetScan(TArray<FAssetData>&& AssetsDataToScan)
+{
+	// 修复后的重定向器已被删除，不再参与检查
+	AssetsDataToScan.RemoveAll([](const FAssetData& AssetData)
 	{
-		if (AssetPathName.Contains(TEXT("Developers"))||
-			AssetPathName.Contains(TEXT("Collections"))||
-			AssetPathName.Contains(TEXT("__ExternalActors__"))||
-			AssetPathName.Contains(TEXT("__ExternalObjects__")))
-		{
-			continue;
-		}
-		if (!UEditorAssetLibrary::DoesAssetExist(AssetPathName))
-		{
-			continue;
-		}
+		return AssetData.IsRedirector();
+	});
 
-		// 检查资源引用数
-		TArray<FString> AssetReferencers =
-		UEditorAssetLibrary::FindPackageReferencersForAsset(AssetPathName);
-		
-		if (AssetReferencers.Num() == 0)
-		{
-			const FAssetData UnusedAssetData = UEditorAssetLibrary::FindAssetData(AssetPathName);
-			UnusedAssetsDataArray.Add(UnusedAssetData);
-		}
-	}
+	// 扫描任务会直接使用已建立的索引，先补全 Asset Manager 完成初始扫描前收集的 Manage 依赖边
+	WaitForAssetReferenceIndexSnapshot();
+	UpdateIndexPrimaryAssetReferencers();
 
-	if (UnusedAssetsDataArray.Num() > 0)
-	{
-		ObjectTools::DeleteAssets(UnusedAssetsDataArray);
-		Debug::ShowNotifyInfo(TEXT("Deleted " + FString::FromInt(0) + " unused assets"));
-	}
+	// 反向依赖索引在多次点击之间常驻，只重算发生变化的包，之后每个资产的引用检查都是 O(1) 查找
+	UnusedAssetScanTask = MakeShared<FUnusedAssetScanTask>(MoveTemp(AssetsDataToScan), AssetReferenceIndex, PathExclusionMatcher,
+		FUnusedAssetScanTask::FOnScanCompleted::CreateRaw(this, &FSuperManagerModule::OnUnusedAssetScanCompleted));
+	UnusedAssetScanTask->Start();
 }
 
-void FSuperManagerModule::OnDeleteEmptyFoldersButtonClicked()
+/**
+ * @brief 后台扫描结束后回到游戏线程，删除找到的未使用资产
+ * @param UnusedAssetsData 未使用的资产
+ */
+void FSuperManagerModule::OnUnusedAssetScanCompleted(const TArray<FAssetData>& UnusedAssetsData)
 {
-	FixUpRedirectors();
-	
-	TArray<FString> FolderPathsArray = UEditorAssetLibrary::ListAssets(FolderPathsSelected[0], true, true);
+	if (UnusedAssetsData.Num() == 0)
+	{
+		Debug::ShowNotifyInfo(TEXT("No unused asset found under selected folder"));
+		return;
+	}
 
-	unsigned int Counter = 0;
-	FString EmptyFolderPathsNames;
-	TArray<FString> EmptyFolderPathsArray;
+	FAssetDeletionOptions DeletionOptions;
+	DeletionOptions.bOnlyUnreferenced = true;
 
-	for (const FString& FolderPath : FolderPathsArray)
+	const TArray<EAssetDeletionResult> DeletionResults =
+		FAssetDeletionService::DeleteAssets(UnusedAssetsData, GetUpToDateAssetReferenceIndex(), DeletionOptions);
+
+	const int32 NumOfAssetsDeleted = FAssetDeletionService::CountResults(DeletionResults, EAssetDeletionResult::Deleted);
+	const int32 NumOfAssetsFailed = FAssetDeletionService::CountResults(DeletionResults, EAssetDeletionResult::Failed)
+		+ FAssetDeletionService::CountResults(DeletionResults, EAssetDeletionResult::Referenced);
+	if (NumOfAssetsDeleted > 0 || NumOfAssetsFailed > 0)
 	{
-		if (FolderPath.Contains(TEXT("Developers"))||
-			FolderPath.Contains(TEXT("Collections"))||
-			FolderPath.Contains(TEXT("__ExternalActors__"))||
-			FolderPath.Contains(TEXT("__ExternalObjects__")))
+		FString NotifyMessage = TEXT("Deleted ") + FString::FromInt(NumOfAssetsDeleted) + TEXT(" unused assets");
+		if (NumOfAssetsFailed > 0)
 		{
-			continue;
+			NotifyMessage += TEXT(", ") + FString::FromInt(NumOfAssetsFailed) + TEXT(" could not be deleted");
 		}
+		Debug::ShowNotifyInfo(NotifyMessage);
+	}
+}
 
-		if (!UEditorAssetLibrary::DoesDirectoryExist(FolderPath))
-		{
-			continue;
-		}
+void FSuperManagerModule::OnDeleteEmptyFoldersButtonClicked()
+{
+	// 只剩重定向器的目录不算空目录，先修复所选目录相关的重定向器
+	// 修复完成时所选目录可能已经改变，点击时按值保存
+	RedirectorFixup.FixUpRedirectorsInPaths(FolderPathsSelected,
+		FRedirectorFixup::FOnFixupCompleted::CreateRaw(this, &FSuperManagerModule::DeleteEmptyFoldersUnderSelectedFolder, FolderPathsSelected[0]));
+}
 
-		if (!UEditorAssetLibrary::DoesDirectoryHaveAssets(FolderPath))
-		{
-			EmptyFolderPathsNames.Append(FolderPath);
-			EmptyFolderPathsNames.Append(TEXT("\n"));
-			EmptyFolderPathsArray.Add(FolderPath);
-		}
+void FSuperManagerModule::DeleteEmptyFoldersUnderSelectedFolder(FString SelectedFolderPath)
+{
+	// 启动扫描期间尚未发现资产的文件夹看起来也是空的
+	if (IAssetRegistry::GetChecked().IsLoadingAssets())
+	{
+		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("Asset registry is still scanning, please try again when it finishes"), false);
+		return;
 	}
 
+	TArray<FName> EmptyFolderPathsArray;
+	FindEmptyFoldersUnder(FName(*SelectedFolderPath), PathExclusionMatcher, EmptyFolderPathsArray);
+
 	if (EmptyFolderPathsArray.Num() == 0)
 	{
 		Debug::ShowMsgDialog(EAppMsgType::Ok, TEXT("No empty folder found under seleted folder"), false);
 		return;
 	}
 
-	EAppReturnType::Type ConfirmResult =
-	Debug::ShowMsgDialog(EAppMsgType::OkCancel, TEXT("Empty folders found in:\n") + EmptyFolderPathsNames + TEXT("\nWould you like to delete all?"), false);
+	// 列表可能很长，用可滚动的对话框代替拼接成一个字符串的消息框
+	const bool bConfirmed = SFolderListConfirmDialog::ShowModal(TEXT("Delete Empty Folders"),
+		FString::FromInt(EmptyFolderPathsArray.Num()) + TEXT(" empty folders found. Would you like to delete all?"),
+		TArray<FName>(EmptyFolderPathsArray));
 
-	if (ConfirmResult == EAppReturnType::Cancel)
+	if (!bConfirmed)
 	{
 		return;
 	}
 
-	for (const FString& EmptyFolderPath : EmptyFolderPathsArray)
+	TArray<FName> FailedFolderPaths;
+	const int32 Counter = DeleteEmptyFolders(EmptyFolderPathsArray, FailedFolderPaths);
+
+	// 只发一条汇总通知，失败的路径写入日志
+	for (const FName FailedFolderPath : FailedFolderPaths)
 	{
-		UEditorAssetLibrary::DeleteDirectory(EmptyFolderPath)
-			? void(++Counter)
-			: Debug::ShowNotifyInfo(TEXT("Failed to deleted " + EmptyFolderPath));
+		Debug::PrintLog(TEXT("Failed to delete ") + FailedFolderPath.ToString());
 	}
 
-	if (Counter > 0)
+	if (FailedFolderPaths.Num() > 0)
+	{
+		Debug::ShowNotifyInfo(TEXT("Deleted ") + FString::FromInt(Counter) + TEXT(" empty folders, failed to delete ")
+			+ FString::FromInt(FailedFolderPaths.Num()) + TEXT(" (see Output Log)"));
+	}
+	else if (Counter > 0)
 	{
 		Debug::ShowNotifyInfo(TEXT("Successfully deleted " + FString::FromInt(Counter) + " empty folders"));
 	}
 }
 
-void FSuperManagerModule::OnAdvanceDeletionButtonClicked()
+/**
+ * @brief 批量删除空文件夹
+ * 只删除最上层的空文件夹，子文件夹随之删除；磁盘上整棵目录一次删除，注册表路径树按根一次移除
+ * 空文件夹来自注册表，注册表仍在扫描时拒绝删除；删除每棵目录前再确认磁盘上没有包文件
+ * @param EmptyFolderPaths 空文件夹，可以包含父子关系
+ * @param OutFailedFolderPaths 删除失败的最上层文件夹
+ * @return 删除的文件夹数量，包括随父文件夹删除的子文件夹
+ */
+int32 FSuperManagerModule::DeleteEmptyFolders(const TArray<FName>& EmptyFolderPaths, TArray<FName>& OutFailedFolderPaths)
 {
-	FixUpRedirectors();
-	// Invoke
-	FGlobalTabmanager::Get()->TryInvokeTab(FName("AdvanceDeletion"));
+	OutFailedFolderPaths.Reset();
+
+	const TSet<FName> EmptyFolderPathSet(EmptyFolderPaths);
+
+	// 祖先也在待删除列表中的文件夹不需要单独删除
+	TArray<FName> RootFolderPaths;
+	for (const FName EmptyFolderPath : EmptyFolderPaths)
+	{
+		bool bHasEmptyAncestor = false;
+		ForEachAncestorPath(EmptyFolderPath, [&EmptyFolderPathSet, &bHasEmptyAncestor](FName AncestorPath)
+		{
+			bHasEmptyAncestor = EmptyFolderPathSet.Contains(AncestorPath);
+			return !bHasEmptyAncestor;
+		});
+
+		if (!bHasEmptyAncestor)
+		{
+			RootFolderPaths.Add(EmptyFolderPath);
+		}
+	}
+
+	IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	if (AssetRegistry.IsLoadingAssets())
+	{
+		Debug::PrintLog(TEXT("Asset registry is still scanning, empty folders are not deleted"));
+		OutFailedFolderPaths = MoveTemp(RootFolderPaths);
+		return 0;
+	}
+
+	FScopedSlowTask SlowTask(RootFolderPaths.Num(), FText::FromString(TEXT("Deleting empty folders...")));
+	SlowTask.MakeDialogDelayed(1.f);
+
+	TSet<FName> FailedRootPaths;
+	for (const FName RootFolderPath : RootFolderPaths)
+	{
+		SlowTask.EnterProgressFrame();
+
+		// 注册表中可能只剩缓存的路径，磁盘上已经不存在，这种情况只需从路径树中移除
+		FString RootFolderFilename;
+		if (!FPackageName::TryConvertLongPackageNameToFilename(RootFolderPath.ToString() + TEXT("/"), RootFolderFilename))
+		{
+			FailedRootPaths.Add(RootFolderPath);
+			continue;
+		}
+
+		// 注册表中没有记录的包文件（如尚未被发现或无法解析的包）不能随目录一起删除
+		if (DirectoryContainsPackageFiles(RootFolderFilename))
+		{
+			Debug::PrintLog(RootFolderPath.ToString() + TEXT(" contains package files on disk, skipped"));
+			FailedRootPaths.Add(RootFolderPath);
+			continue;
+		}
+
+		if (!IFileManager::Get().DeleteDirectory(*RootFolderFilename, false, true))
+		{
+			FailedRootPaths.Add(RootFolderPath);
+			continue;
+		}
+
+		AssetRegistry.RemovePath(RootFolderPath.ToString());
+	}
+
+	OutFailedFolderPaths = FailedRootPaths.Array();
+
+	// 统计实际删除的文件夹：根删除成功时，其下的空文件夹也一并删除
+	int32 NumDeletedFolders = 0;
+	for (const FName EmptyFolderPath : EmptyFolderPaths)
+	{
+		bool bUnderFailedRoot = FailedRootPaths.Contains(EmptyFolderPath);
+		ForEachAncestorPath(EmptyFolderPath, [&FailedRootPaths, &bUnderFailedRoot](FName AncestorPath)
+		{
+			bUnderFailedRoot = bUnderFailedRoot || FailedRootPaths.Contains(AncestorPath);
+			return !bUnderFailedRoot;
+		});
+
+		NumDeletedFolders += bUnderFailedRoot ? 0 : 1;
+	}
+
+	return NumDeletedFolders;
 }
 
-void FSuperManagerModule::FixUpRedirectors()
+/**
+ * @brief 一次遍历注册表缓存的路径树，找出子树中没有任何资产的文件夹
+ * 每个含有资产的文件夹向上标记祖先为非空，遇到已标记的祖先即停止，每个文件夹最多被标记一次，整体是线性的
+ * @param RootPath 根目录，本身不参与判断
+ * @param ExclusionMatcher 排除规则，排除的文件夹视为非空
+ * @param OutEmptyFolderPaths 空文件夹，按路径排序
+ */
+void FSuperManagerModule::FindEmptyFoldersUnder(FName RootPath, const FPathExclusionMatcher& ExclusionMatcher, TArray<FName>& OutEmptyFolderPaths)
 {
-	TArray<UObjectRedirector*> RedirectorsToFixArray;
+	OutEmptyFolderPaths.Reset();
 
-	// 通过 FModuleManager 类加载模块，LoadModuleChecked 方法保证了模块不会被重复加载
-	// 使用 AssetRegistryModule 的 GetAssets() 方法来获取所有需要重定向的资产数据
-	FAssetRegistryModule& AssetRegistryModule =
-	FModuleManager::Get().LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry"));
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
 
-	// 创建 GetAssets() 所需的筛选器
+	TArray<FName> SubPaths;
+	AssetRegistry.GetSubPaths(RootPath, SubPaths, true);
+
+	// 直接包含资产的文件夹
 	FARFilter Filter;
-	Filter.bRecursivePaths = true;					// 递归子文件夹
-	Filter.bRecursiveClasses = true;				// 包括派生类
-	Filter.PackagePaths.Add("/Game");
-	Filter.ClassPaths.Add(UObjectRedirector::StaticClass()->GetClassPathName());
+	Filter.bRecursivePaths = true;
+	Filter.PackagePaths.Add(RootPath);
 
-	// 需要重定向的资产数据
-	TArray<FAssetData> OutRedirectors;
-	AssetRegistryModule.Get().GetAssets(Filter, OutRedirectors, false);
+	TSet<FName> NonEmptyFolderPaths;
+	AssetRegistry.EnumerateAssets(Filter, [&NonEmptyFolderPaths](const FAssetData& AssetData)
+	{
+		NonEmptyFolderPaths.Add(AssetData.PackagePath);
+		return true;
+	});
 
-	// FAssetData.GetAsset() 得到 UObject*, 将其转换成 UObjectRedirector*
-	for (const FAssetData& RedirectorData : OutRedirectors)
+	// 排除的文件夹按非空处理，这样它的父文件夹也不会被当作空文件夹整个删除
+	for (const FName SubPath : SubPaths)
 	{
-		if (UObjectRedirector* RedirectorToFix = Cast<UObjectRedirector>(RedirectorData.GetAsset()))
+		if (ExclusionMatcher.IsFolderExcluded(SubPath))
 		{
-			RedirectorsToFixArray.Add(RedirectorToFix);
+			NonEmptyFolderPaths.Add(SubPath);
 		}
 	}
 
-	// 使用 AssetToolsModule 中的 FixupReferencers() 方法来修复重定向器
-	FAssetToolsModule& AssetToolsModule =
-	FModuleManager::Get().LoadModuleChecked<FAssetToolsModule>(TEXT("AssetTools"));
+	// 把非空状态传递给所有祖先
+	TArray<FName> FolderPathsWithAssets = NonEmptyFolderPaths.Array();
+	for (const FName FolderPathWithAssets : FolderPathsWithAssets)
+	{
+		ForEachAncestorPath(FolderPathWithAssets, [&NonEmptyFolderPaths, RootPath](FName AncestorPath)
+		{
+			if (AncestorPath == RootPath)
+			{
+				return false;
+			}
 
-	AssetToolsModule.Get().FixupReferencers(RedirectorsToFixArray);
+			bool bAlreadyNonEmpty = false;
+			NonEmptyFolderPaths.Add(AncestorPath, &bAlreadyNonEmpty);
+			return !bAlreadyNonEmpty;
+		});
+	}
+
+	for (const FName SubPath : SubPaths)
+	{
+		if (!NonEmptyFolderPaths.Contains(SubPath))
+		{
+			OutEmptyFolderPaths.Add(SubPath);
+		}
+	}
+
+	OutEmptyFolderPaths.Sort(FNameLexicalLess());
+}
+
+void FSuperManagerModule::OnAdvanceDeletionButtonClicked()
+{
+	// 修复完成后再打开面板，面板中列出的资产不包含重定向器
+	RedirectorFixup.FixUpRedirectorsInPaths(FolderPathsSelected,
+		FRedirectorFixup::FOnFixupCompleted::CreateLambda([this, SelectedFolderPaths = FolderPathsSelected]()
+		{
+			AdvanceDeletionFolderPaths = SelectedFolderPaths;
+
+			// Invoke
+			FGlobalTabmanager::Get()->TryInvokeTab(FName("AdvanceDeletion"));
+		}));
 }
 
 #pragma endregion
@@ -268,33 +491,34 @@ TSharedRef<SDockTab> FSuperManagerModule::OnSpawnAdvanceDeletionTab(const FSpawn
 	[
 		// 构造 SAdvanceDeletionTab，传入参数
 		SNew(SAdvanceDeletionTab)
-		.AssetsDataToStore(GetAllAssetDataUnderSelectedFolder())
-		.CurrentSelectedFolder(FolderPathsSelected[0])
+		.AssetListModel(GetAllAssetDataUnderSelectedFolder())
+		.CurrentSelectedFolder(AdvanceDeletionFolderPaths[0])
 	];
 }
 
-TArray<TSharedPtr<FAssetData>> FSuperManagerModule::GetAllAssetDataUnderSelectedFolder()
+/**
+ * @brief 用一次注册表查询取出所选目录下的全部资产，存入连续数组交给列表模型
+ * @return 列表模型
+ */
+TSharedRef<FAdvanceDeletionListModel> FSuperManagerModule::GetAllAssetDataUnderSelectedFolder()
 {
-	TArray<TSharedPtr<FAssetData>> AvailableAssetsData;
-	TArray<FString> AssetsPathNames = UEditorAssetLibrary::ListAssets(FolderPathsSelected[0]);
-	for (const FString& AssetPathName : AssetsPathNames)
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& FolderPathSelected : AdvanceDeletionFolderPaths)
 	{
-		if (AssetPathName.Contains(TEXT("Developers"))||
-			AssetPathName.Contains(TEXT("Collections"))||
-			AssetPathName.Contains(TEXT("__ExternalActors__"))||
-			AssetPathName.Contains(TEXT("__ExternalObjects__")))
-		{
-			continue;
-		}
-		if (!UEditorAssetLibrary::DoesAssetExist(AssetPathName))
-		{
-			continue;
-		}
-
-		const FAssetData Data = UEditorAssetLibrary::FindAssetData(AssetPathName);
-		AvailableAssetsData.Add(MakeShared<FAssetData>(Data));
+		Filter.PackagePaths.Add(FName(*FolderPathSelected));
 	}
-	return AvailableAssetsData;
+
+	TArray<FAssetData> AvailableAssetsData;
+	IAssetRegistry::GetChecked().GetAssets(Filter, AvailableAssetsData);
+
+	// 一次遍历剔除排除目录下的资产和重定向器
+	AvailableAssetsData.RemoveAll([this](const FAssetData& AssetData)
+	{
+		return AssetData.IsRedirector() || PathExclusionMatcher.IsAssetExcluded(AssetData);
+	});
+
+	return MakeShared<FAdvanceDeletionListModel>(MoveTemp(AvailableAssetsData));
 }
 
 #pragma endregion
@@ -302,76 +526,281 @@ TArray<TSharedPtr<FAssetData>> FSuperManagerModule::GetAllAssetDataUnderSelected
 
 #pragma region ProccessDataForAdvanceDelectionTab
 
-bool FSuperManagerModule::DeleteSingleAssetForAssetList(const FAssetData& AssetDataToDelete)
+/**
+ * @brief 删除列表中的资产，被引用的资产交给引擎的删除对话框处理
+ * @return 与 AssetsToDelete 一一对应的删除结果
+ */
+TArray<EAssetDeletionResult> FSuperManagerModule::DeleteAssetsForAssetList(const TArray<FAssetData>& AssetsToDelete)
 {
-	TArray<FAssetData> AssetDataForDeleteArray;
-	AssetDataForDeleteArray.Add(AssetDataToDelete);
-	
-	if (ObjectTools::DeleteAssets(AssetDataForDeleteArray) > 0)
+	return FAssetDeletionService::DeleteAssets(AssetsToDelete, GetUpToDateAssetReferenceIndex());
+}
+
+void FSuperManagerModule::ListUnusedAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
+	TArray<TSharedPtr<FAssetData>>& OutUnusedAssetsData)
+{
+	OutUnusedAssetsData.Empty();
+
+	const FAssetReferenceIndex& ReferenceIndex = GetUpToDateAssetReferenceIndex();
+
+	// 每个资产的检查互不相关，按块分给工作线程，每块写入自己的结果数组，合并时保持原有顺序
+	constexpr int32 ChunkSize = 1024;
+	const int32 NumAssets = AssetDataToFilter.Num();
+	const int32 NumChunks = FMath::DivideAndRoundUp(NumAssets, ChunkSize);
+
+	TArray<TArray<TSharedPtr<FAssetData>>> ChunkResults;
+	ChunkResults.SetNum(NumChunks);
+
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
 	{
-		return true;
+		const int32 ChunkStart = ChunkIndex * ChunkSize;
+		const int32 ChunkEnd = FMath::Min(ChunkStart + ChunkSize, NumAssets);
+
+		for (int32 AssetIndex = ChunkStart; AssetIndex < ChunkEnd; ++AssetIndex)
+		{
+			const TSharedPtr<FAssetData>& DataSharedPtr = AssetDataToFilter[AssetIndex];
+			if (ReferenceIndex.IsPackageUnused(DataSharedPtr->PackageName))
+			{
+				ChunkResults[ChunkIndex].Add(DataSharedPtr);
+			}
+		}
+	});
+
+	for (TArray<TSharedPtr<FAssetData>>& ChunkResult : ChunkResults)
+	{
+		OutUnusedAssetsData.Append(MoveTemp(ChunkResult));
 	}
-	return false;
 }
 
-bool FSuperManagerModule::DeleteMultipleAssetsForAssetList(const TArray<FAssetData>& AssetsToDelete)
+/**
+ * @brief 列出从根出发不可达的资产
+ * 只被其他不可达资产引用的资产也会被列出，整个无用的子图一次就能找全
+ * 排除目录下的资产作为根，它们的依赖不会被列出；尚未保存、不在索引中的资产视为可达
+ * @param AssetDataToFilter 待检查的资产
+ * @param OutUnreachableAssetsData 不可达的资产
+ */
+void FSuperManagerModule::ListUnreachableAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
+	TArray<TSharedPtr<FAssetData>>& OutUnreachableAssetsData)
 {
-	if (ObjectTools::DeleteAssets(AssetsToDelete) > 0)
+	OutUnreachableAssetsData.Empty();
+
+	const FAssetReferenceIndex& ReferenceIndex = GetUpToDateAssetReferenceIndex();
+
+	TArray<FAssetIdentifier> RootIdentifiers;
+	AssetReachabilityRoots.GatherRootIdentifiers(RootIdentifiers);
+
+	TSet<FName> ReachablePackageNames;
+	// 遍历时对索引中的每个包都会调用，包路径在栈上的缓冲区中截取，不分配 FString
+	ReferenceIndex.FindReachablePackages(RootIdentifiers, [this](FName PackageName)
 	{
-		return true;
+		if (AssetReachabilityRoots.IsRootPackage(PackageName))
+		{
+			return true;
+		}
+
+		TStringBuilder<256> PackageNameBuilder;
+		PackageName.ToString(PackageNameBuilder);
+		return PathExclusionMatcher.IsFolderExcluded(FPathViews::GetPath(PackageNameBuilder.ToView()));
+	}, ReachablePackageNames);
+
+	for (const TSharedPtr<FAssetData>& DataSharedPtr : AssetDataToFilter)
+	{
+		const FName PackageName = DataSharedPtr->PackageName;
+		if (!ReachablePackageNames.Contains(PackageName) && ReferenceIndex.IsPackageIndexed(PackageName))
+		{
+			OutUnreachableAssetsData.Add(DataSharedPtr);
+		}
 	}
-	return false;
 }
 
-void FSuperManagerModule::ListUnusedAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
-	TArray<TSharedPtr<FAssetData>>& OutUnusedAssetsData)
+/**
+ * @brief 按键把资产分组，只保留多于一个资产的组
+ * 同组资产在输出中占据连续区间，组的顺序和组内顺序都与输入中首次出现的顺序一致，组名取组内第一个资产的名称
+ * @param AssetDataToGroup 待分组的资产
+ * @param GetGroupKey 取第 AssetIndex 个资产的键，返回 false 表示该资产不参与分组
+ * @param OutGroupedAssetsData 分组后的资产
+ * @param OutAssetGroups 每组在 OutGroupedAssetsData 中的区间
+ */
+template<typename KeyType>
+void FSuperManagerModule::GroupAssetsByKey(const TArray<TSharedPtr<FAssetData>>& AssetDataToGroup,
+	TFunctionRef<bool(int32 AssetIndex, KeyType& OutKey)> GetGroupKey,
+	TArray<TSharedPtr<FAssetData>>& OutGroupedAssetsData, TArray<FAssetDataGroup>& OutAssetGroups)
 {
-	OutUnusedAssetsData.Empty();
-	
-	for (const TSharedPtr<FAssetData>& DataSharedPtr : AssetDataToFilter)
+	OutGroupedAssetsData.Reset();
+	OutAssetGroups.Reset();
+
+	// 第一遍：记录每个资产所属的组和每组的大小
+	TMap<KeyType, int32> KeyToGroupIndex;
+	KeyToGroupIndex.Reserve(AssetDataToGroup.Num());
+
+	TArray<FAssetDataGroup> AllGroups;
+	TArray<int32> AssetGroupIndices;
+	AssetGroupIndices.Reserve(AssetDataToGroup.Num());
+
+	for (int32 AssetIndex = 0; AssetIndex < AssetDataToGroup.Num(); ++AssetIndex)
+	{
+		KeyType GroupKey;
+		if (!AssetDataToGroup[AssetIndex].IsValid() || !GetGroupKey(AssetIndex, GroupKey))
+		{
+			AssetGroupIndices.Add(INDEX_NONE);
+			continue;
+		}
+
+		int32 GroupIndex;
+		if (const int32* FoundGroupIndex = KeyToGroupIndex.Find(GroupKey))
+		{
+			GroupIndex = *FoundGroupIndex;
+		}
+		else
+		{
+			GroupIndex = AllGroups.Add({ AssetDataToGroup[AssetIndex]->AssetName, 0, 0 });
+			KeyToGroupIndex.Add(GroupKey, GroupIndex);
+		}
+
+		++AllGroups[GroupIndex].Num;
+		AssetGroupIndices.Add(GroupIndex);
+	}
+
+	// 第二遍：只保留多于一个资产的组，为每组分配连续区间
+	TArray<int32> GroupWriteCursors;
+	GroupWriteCursors.Init(INDEX_NONE, AllGroups.Num());
+
+	int32 NumGroupedAssets = 0;
+	for (int32 GroupIndex = 0; GroupIndex < AllGroups.Num(); ++GroupIndex)
 	{
-		TArray<FString> AssetReferencers =
-		UEditorAssetLibrary::FindPackageReferencersForAsset(DataSharedPtr->GetSoftObjectPath().ToString());
+		FAssetDataGroup& Group = AllGroups[GroupIndex];
+		if (Group.Num <= 1)
+		{
+			continue;
+		}
 
-		if (AssetReferencers.Num() == 0)
+		Group.StartIndex = NumGroupedAssets;
+		GroupWriteCursors[GroupIndex] = NumGroupedAssets;
+		NumGroupedAssets += Group.Num;
+		OutAssetGroups.Add(Group);
+	}
+
+	// 第三遍：按输入顺序把资产写入各自组的区间
+	OutGroupedAssetsData.SetNum(NumGroupedAssets);
+	for (int32 AssetIndex = 0; AssetIndex < AssetDataToGroup.Num(); ++AssetIndex)
+	{
+		const int32 GroupIndex = AssetGroupIndices[AssetIndex];
+		if (GroupIndex != INDEX_NONE && GroupWriteCursors[GroupIndex] != INDEX_NONE)
 		{
-			OutUnusedAssetsData.Add(DataSharedPtr);
+			OutGroupedAssetsData[GroupWriteCursors[GroupIndex]++] = AssetDataToGroup[AssetIndex];
 		}
 	}
 }
 
+/**
+ * @brief 找出同名资产并按名称分组
+ * 以 FName 为键分组，比较的是名称表下标和数字后缀，不需要转换成字符串，整个过程是线性的
+ * @param AssetDataToFilter 待筛选的资产
+ * @param OutSameNameAssetsData 同名资产，同一组的资产相邻，组的顺序和组内顺序都与输入中首次出现的顺序一致
+ * @param OutAssetGroups 每组在 OutSameNameAssetsData 中的区间
+ */
 void FSuperManagerModule::ListSameNameAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
-	TArray<TSharedPtr<FAssetData>>& OutSameNameAssetsData)
+	TArray<TSharedPtr<FAssetData>>& OutSameNameAssetsData, TArray<FAssetDataGroup>& OutAssetGroups)
 {
-	OutSameNameAssetsData.Empty();
+	GroupAssetsByKey<FName>(AssetDataToFilter, [&AssetDataToFilter](int32 AssetIndex, FName& OutKey)
+	{
+		OutKey = AssetDataToFilter[AssetIndex]->AssetName;
+		return true;
+	}, OutSameNameAssetsData, OutAssetGroups);
+}
 
-	TMultiMap<FString, TSharedPtr<FAssetData>> AssetsInfoMultiMap;
+/**
+ * @brief 找出磁盘上内容相同的资产并分组，用于发现以不同名称重复导入的贴图、网格等
+ * 哈希按包计算并缓存，同一个包里的多个资产共用一个键
+ * @param AssetDataToFilter 待筛选的资产
+ * @param OutIdenticalAssetsData 内容相同的资产，同一组的资产相邻
+ * @param OutAssetGroups 每组在 OutIdenticalAssetsData 中的区间
+ */
+void FSuperManagerModule::ListIdenticalContentAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
+	TArray<TSharedPtr<FAssetData>>& OutIdenticalAssetsData, TArray<FAssetDataGroup>& OutAssetGroups)
+{
+	TArray<FName> PackageNames;
+	TArray<int32> AssetPackageIndices;
+	GatherPackagesForAssetList(AssetDataToFilter, PackageNames, AssetPackageIndices);
 
-	for (const TSharedPtr<FAssetData>& DataSharedPtr : AssetDataToFilter)
-	{
-		AssetsInfoMultiMap.Emplace(DataSharedPtr->AssetName.ToString(), DataSharedPtr);
-	}
+	TArray<FPackageContentKey> ContentKeys;
+	PackageContentHashCache.ComputeContentKeys(PackageNames, ContentKeys);
+
+	GroupAssetsByContentKey(AssetDataToFilter, AssetPackageIndices, ContentKeys, OutIdenticalAssetsData, OutAssetGroups);
+}
+
+/**
+ * @brief 与 ListIdenticalContentAssetsForAssetList 相同，但包的读取和哈希计算在线程池中进行，不阻塞游戏线程
+ * @param AssetDataToFilter 待筛选的资产
+ * @param OnCompleted 在游戏线程调用，参数为内容相同的资产和分组
+ */
+void FSuperManagerModule::ListIdenticalContentAssetsForAssetListAsync(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
+	TFunction<void(TArray<TSharedPtr<FAssetData>>&& IdenticalAssetsData, TArray<FAssetDataGroup>&& AssetGroups)>&& OnCompleted)
+{
+	TArray<FName> PackageNames;
+	TArray<int32> AssetPackageIndices;
+	GatherPackagesForAssetList(AssetDataToFilter, PackageNames, AssetPackageIndices);
+
+	PackageContentHashCache.ComputeContentKeysAsync(MoveTemp(PackageNames),
+		[this, AssetDataToFilter, AssetPackageIndices = MoveTemp(AssetPackageIndices), OnCompleted = MoveTemp(OnCompleted)]
+		(TArray<FPackageContentKey>&& ContentKeys)
+		{
+			TArray<TSharedPtr<FAssetData>> IdenticalAssetsData;
+			TArray<FAssetDataGroup> AssetGroups;
+			GroupAssetsByContentKey(AssetDataToFilter, AssetPackageIndices, ContentKeys, IdenticalAssetsData, AssetGroups);
+
+			OnCompleted(MoveTemp(IdenticalAssetsData), MoveTemp(AssetGroups));
+		});
+}
+
+/**
+ * @brief 收集资产所在的包，同一个包只出现一次
+ * @param AssetDataToFilter 资产
+ * @param OutPackageNames 包名
+ * @param OutAssetPackageIndices 每个资产的包在 OutPackageNames 中的下标，无效的资产为 INDEX_NONE
+ */
+void FSuperManagerModule::GatherPackagesForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
+	TArray<FName>& OutPackageNames, TArray<int32>& OutAssetPackageIndices)
+{
+	TMap<FName, int32> PackageNameToIndex;
+	OutAssetPackageIndices.Reserve(AssetDataToFilter.Num());
 
 	for (const TSharedPtr<FAssetData>& DataSharedPtr : AssetDataToFilter)
 	{
-		TArray<TSharedPtr<FAssetData>> OutAssetsData;
-		AssetsInfoMultiMap.MultiFind(DataSharedPtr->AssetName.ToString(), OutAssetsData);
-
-		if (OutAssetsData.Num() <= 1)
+		if (!DataSharedPtr.IsValid())
 		{
+			OutAssetPackageIndices.Add(INDEX_NONE);
 			continue;
 		}
 
-		for (const TSharedPtr<FAssetData>& SameNameData : OutAssetsData)
+		int32 PackageIndex;
+		if (const int32* FoundPackageIndex = PackageNameToIndex.Find(DataSharedPtr->PackageName))
 		{
-			if (SameNameData.IsValid())
-			{
-				OutSameNameAssetsData.AddUnique(SameNameData);
-			}
+			PackageIndex = *FoundPackageIndex;
 		}
+		else
+		{
+			PackageIndex = OutPackageNames.Add(DataSharedPtr->PackageName);
+			PackageNameToIndex.Add(DataSharedPtr->PackageName, PackageIndex);
+		}
+		OutAssetPackageIndices.Add(PackageIndex);
 	}
 }
 
+void FSuperManagerModule::GroupAssetsByContentKey(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, const TArray<int32>& AssetPackageIndices,
+	const TArray<FPackageContentKey>& ContentKeys, TArray<TSharedPtr<FAssetData>>& OutIdenticalAssetsData, TArray<FAssetDataGroup>& OutAssetGroups)
+{
+	GroupAssetsByKey<FPackageContentKey>(AssetDataToFilter, [&AssetPackageIndices, &ContentKeys](int32 AssetIndex, FPackageContentKey& OutKey)
+	{
+		const int32 PackageIndex = AssetPackageIndices[AssetIndex];
+		if (PackageIndex == INDEX_NONE || !ContentKeys[PackageIndex].IsValid())
+		{
+			return false;
+		}
+		OutKey = ContentKeys[PackageIndex];
+		return true;
+	}, OutIdenticalAssetsData, OutAssetGroups);
+}
+
 void FSuperManagerModule::SyncCBToClickedAssetForAssetList(const FString& AssetPathToSync)
 {
 	TArray<FString> AssetsPathToSync;
@@ -383,12 +812,204 @@ void FSuperManagerModule::SyncCBToClickedAssetForAssetList(const FString& AssetP
 #pragma endregion
 
 
+#pragma region AssetReferenceIndex
+
+/**
+ * @brief 获取最新的反向依赖索引，供所有查找未使用资产的入口共享
+ * 首次调用时遍历一次依赖图建立索引，之后只重算注册表事件标记过的包
+ * @return 最新的索引
+ */
+const FAssetReferenceIndex& FSuperManagerModule::GetUpToDateAssetReferenceIndex()
+{
+	// 快照恢复完成前不要重复建立索引
+	WaitForAssetReferenceIndexSnapshot();
+
+	// 信任 bIsBuilt 之前，先补全 Asset Manager 完成初始扫描前收集的 Manage 依赖边
+	UpdateIndexPrimaryAssetReferencers();
+	if (!AssetReferenceIndex.IsBuilt())
+	{
+		AssetReferenceIndex.EnsureBuilt(FAssetReferenceIndex::GatherPrimaryAssetReferencers());
+	}
+	AssetReferenceIndex.RefreshInvalidatedPackages();
+
+	return AssetReferenceIndex;
+}
+
+void FSuperManagerModule::RegisterAssetRegistryEvents()
+{
+	IAssetRegistry& AssetRegistry =
+	FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+
+	AssetRegistry.OnAssetAdded().AddRaw(this, &FSuperManagerModule::OnAssetAdded);
+	AssetRegistry.OnAssetRemoved().AddRaw(this, &FSuperManagerModule::OnAssetRemoved);
+	AssetRegistry.OnAssetRenamed().AddRaw(this, &FSuperManagerModule::OnAssetRenamed);
+	AssetRegistry.OnAssetUpdated().AddRaw(this, &FSuperManagerModule::OnAssetUpdated);
+	AssetRegistry.OnFilesLoaded().AddRaw(this, &FSuperManagerModule::OnAssetRegistryFilesLoaded);
+}
+
+void FSuperManagerModule::UnregisterAssetRegistryEvents()
+{
+	// 关闭编辑器时 AssetRegistry 模块可能已经先被卸载
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>(TEXT("AssetRegistry")))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+		AssetRegistry.OnAssetUpdated().RemoveAll(this);
+		AssetRegistry.OnFilesLoaded().RemoveAll(this);
+	}
+}
+
+void FSuperManagerModule::OnAssetAdded(const FAssetData& AssetData)
+{
+	InvalidateIndexedPackage(AssetData.PackageName);
+	RedirectorFixup.OnAssetAdded(AssetData);
+}
+
+void FSuperManagerModule::OnAssetRemoved(const FAssetData& AssetData)
+{
+	InvalidateIndexedPackage(AssetData.PackageName);
+	RedirectorFixup.OnAssetRemoved(AssetData);
+}
+
+void FSuperManagerModule::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	// 重命名相当于旧包被移除、新包被添加，两者都需要重算
+	InvalidateIndexedPackage(AssetData.PackageName);
+	InvalidateIndexedPackage(FName(*FPackageName::ObjectPathToPackageName(OldObjectPath)));
+	RedirectorFixup.OnAssetRenamed(AssetData, OldObjectPath);
+}
+
+void FSuperManagerModule::OnAssetUpdated(const FAssetData& AssetData)
+{
+	InvalidateIndexedPackage(AssetData.PackageName);
+}
+
+void FSuperManagerModule::OnAssetRegistryFilesLoaded()
+{
+	// 启动扫描期间建立的索引是不完整的，扫描完成后丢弃，从快照恢复，快照无效时下次使用时重新建立
+	WaitForAssetReferenceIndexSnapshot();
+	AssetReferenceIndex.Reset();
+	if (!RedirectorFixup.Reset())
+	{
+		// 修复进行中时保留状态，启动扫描期间收集的已知重定向器本来就会在下次使用时重新收集
+		Debug::PrintLog(TEXT("Redirector fixup is running, keep its state"));
+	}
+	StartLoadingAssetReferenceIndexSnapshot();
+}
+
+/**
+ * @brief 等 Asset Manager 完成初始扫描后再从快照恢复索引
+ * 编辑器中 Asset Manager 同样在注册表扫描完成时才完成初始扫描，此前收集的 PrimaryAssetId 不完整，Manage 依赖边会缺失
+ */
+void FSuperManagerModule::StartLoadingAssetReferenceIndexSnapshot()
+{
+	if (bIsWaitingForAssetManagerScan)
+	{
+		return;
+	}
+
+	bIsWaitingForAssetManagerScan = true;
+	UAssetManager::CallOrRegister_OnCompletedInitialScan(
+		FSimpleMulticastDelegate::FDelegate::CreateRaw(this, &FSuperManagerModule::LoadAssetReferenceIndexSnapshotAsync));
+}
+
+/**
+ * @brief 在线程池中从快照恢复索引，PrimaryAssetId 需要先在游戏线程收集
+ */
+void FSuperManagerModule::LoadAssetReferenceIndexSnapshotAsync()
+{
+	bIsWaitingForAssetManagerScan = false;
+	WaitForAssetReferenceIndexSnapshot();
+
+	// 等待期间已经在使用中建立的索引只需要补全 Manage 依赖边，快照不会覆盖已建立的索引
+	UpdateIndexPrimaryAssetReferencers();
+
+	AssetReferenceIndexLoadFuture = Async(EAsyncExecution::ThreadPool,
+		[this, PrimaryAssetReferencers = FAssetReferenceIndex::GatherPrimaryAssetReferencers()]()
+		{
+			if (!AssetReferenceIndex.LoadSnapshot(GetAssetReferenceIndexSnapshotPath(), PrimaryAssetReferencers))
+			{
+				Debug::PrintLog(TEXT("Asset reference index snapshot not loaded, index will be built on first use"));
+			}
+		});
+}
+
+/**
+ * @brief 索引中的 Manage 依赖边是在 Asset Manager 完成初始扫描前收集的，扫描完成后重新收集并替换
+ * 索引尚未建立时，之后建立索引时收集到的 PrimaryAssetId 已经是完整的
+ */
+void FSuperManagerModule::UpdateIndexPrimaryAssetReferencers()
+{
+	if (bIndexHasAllPrimaryAssetReferencers || !FAssetReferenceIndex::HasAssetManagerCompletedInitialScan())
+	{
+		return;
+	}
+
+	bIndexHasAllPrimaryAssetReferencers = true;
+	AssetReferenceIndex.ReplacePrimaryAssetReferencers(FAssetReferenceIndex::GatherPrimaryAssetReferencers());
+}
+
+void FSuperManagerModule::WaitForAssetReferenceIndexSnapshot()
+{
+	if (AssetReferenceIndexLoadFuture.IsValid())
+	{
+		AssetReferenceIndexLoadFuture.Wait();
+		AssetReferenceIndexLoadFuture.Reset();
+	}
+}
+
+void FSuperManagerModule::SaveAssetReferenceIndexSnapshot()
+{
+	WaitForAssetReferenceIndexSnapshot();
+
+	if (AssetReferenceIndex.IsBuilt() && !AssetReferenceIndex.SaveSnapshot(GetAssetReferenceIndexSnapshotPath()))
+	{
+		Debug::PrintLog(TEXT("Failed to save asset reference index snapshot"));
+	}
+}
+
+FString FSuperManagerModule::GetAssetReferenceIndexSnapshotPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("SuperManager") / TEXT("AssetReferenceIndex.bin");
+}
+
+void FSuperManagerModule::InvalidateIndexedPackage(FName PackageName)
+{
+	// 启动扫描期间的海量事件无需记录，扫描完成后索引会整体重建
+	if (IAssetRegistry::GetChecked().IsLoadingAssets())
+	{
+		return;
+	}
+
+	// 后台线程可能正在建立索引，所以即使索引尚未建立也要记录
+	AssetReferenceIndex.InvalidatePackage(PackageName);
+}
+
+#pragma endregion
+
+
 void FSuperManagerModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FName("AdvanceDeletion"));
 	FSuperManagerStyle::Shutdown();
+	UnregisterAssetRegistryEvents();
+	FCoreDelegates::OnPreExit.Remove(PreExitDelegateHandle);
+	WaitForAssetReferenceIndexSnapshot();
+	PackageContentHashCache.CancelAndWait();
+
+	if (UnusedAssetScanTask.IsValid())
+	{
+		UnusedAssetScanTask->CancelAndWait();
+		UnusedAssetScanTask.Reset();
+	}
+
+	AssetReferenceIndex.Reset();
+	RedirectorFixup.Shutdown();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,356 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "SuperManagerCommandlet.h"
+
+#include "SuperManager.h"
+#include "AssetRegistry/ARFilter.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSuperManagerCommandlet, Log, All);
+
+namespace
+{
+	TArray<FString> ParseListArgument(const FString& Params, const TCHAR* Name)
+	{
+		FString Value;
+		TArray<FString> Values;
+		if (FParse::Value(*Params, Name, Value, false))
+		{
+			Value.ParseIntoArray(Values, TEXT("+"), true);
+		}
+		return Values;
+	}
+
+	TArray<TSharedPtr<FJsonValue>> MakeJsonStringArray(const TArray<FString>& Strings)
+	{
+		TArray<TSharedPtr<FJsonValue>> JsonValues;
+		JsonValues.Reserve(Strings.Num());
+		for (const FString& String : Strings)
+		{
+			JsonValues.Add(MakeShared<FJsonValueString>(String));
+		}
+		return JsonValues;
+	}
+
+	/** 分组结果写成 [{ "name": ..., "assets": [...] }] */
+	TArray<TSharedPtr<FJsonValue>> MakeJsonAssetGroups(const TArray<TSharedPtr<FAssetData>>& GroupedAssetsData, const TArray<FAssetDataGroup>& AssetGroups)
+	{
+		TArray<TSharedPtr<FJsonValue>> JsonGroups;
+		JsonGroups.Reserve(AssetGroups.Num());
+		for (const FAssetDataGroup& Group : AssetGroups)
+		{
+			TArray<FString> ObjectPaths;
+			for (int32 AssetIndex = Group.StartIndex; AssetIndex < Group.StartIndex + Group.Num; ++AssetIndex)
+			{
+				ObjectPaths.Add(GroupedAssetsData[AssetIndex]->GetObjectPathString());
+			}
+
+			TSharedRef<FJsonObject> JsonGroup = MakeShared<FJsonObject>();
+			JsonGroup->SetStringField(TEXT("name"), Group.GroupName.ToString());
+			JsonGroup->SetArrayField(TEXT("assets"), MakeJsonStringArray(ObjectPaths));
+			JsonGroups.Add(MakeShared<FJsonValueObject>(JsonGroup));
+		}
+		return JsonGroups;
+	}
+}
+
+USuperManagerCommandlet::USuperManagerCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Finds and optionally cleans up redirectors, unused assets and empty folders, and reports duplicate assets as JSON.");
+	HelpUsage = TEXT("-run=SuperManager -nullrhi [-Apply] [-Paths=/Game/A+/Game/B] [-Tasks=Redirectors+Unused+EmptyFolders+SameName+IdenticalContent] "
+		"[-ExcludeFolders=Name1+Name2] [-ExcludePrefixes=/Game/ThirdParty] [-RedirectorTimeout=<Seconds>] [-Report=<File>]");
+}
+
+int32 USuperManagerCommandlet::Main(const FString& Params)
+{
+	bApply = FParse::Param(*Params, TEXT("Apply"));
+	NumFailures = 0;
+
+	if (!FParse::Value(*Params, TEXT("RedirectorTimeout="), RedirectorTimeoutSeconds))
+	{
+		RedirectorTimeoutSeconds = DefaultRedirectorTimeoutSeconds;
+	}
+
+	PackagePaths = ParseListArgument(Params, TEXT("Paths="));
+	if (PackagePaths.Num() == 0)
+	{
+		PackagePaths.Add(TEXT("/Game"));
+	}
+
+	TArray<FString> Tasks = ParseListArgument(Params, TEXT("Tasks="));
+	if (Tasks.Num() == 0)
+	{
+		Tasks = { TEXT("Redirectors"), TEXT("Unused"), TEXT("EmptyFolders"), TEXT("SameName"), TEXT("IdenticalContent") };
+	}
+
+	PathExclusionMatcher.LoadFromPluginConfig(ParseListArgument(Params, TEXT("ExcludeFolders=")), ParseListArgument(Params, TEXT("ExcludePrefixes=")));
+
+	FString ReportFilePath;
+	if (!FParse::Value(*Params, TEXT("Report="), ReportFilePath))
+	{
+		ReportFilePath = FPaths::ProjectSavedDir() / TEXT("SuperManager") / TEXT("CleanupReport.json");
+	}
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Scanning asset registry (%s mode)..."), bApply ? TEXT("apply") : TEXT("dry-run"));
+	IAssetRegistry::GetChecked().SearchAllAssets(true);
+
+	FSuperManagerModule& SuperManagerModule =
+	FModuleManager::LoadModuleChecked<FSuperManagerModule>(TEXT("SuperManager"));
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("mode"), bApply ? TEXT("apply") : TEXT("dry-run"));
+	Report->SetArrayField(TEXT("paths"), MakeJsonStringArray(PackagePaths));
+
+	// 重定向器先于未使用资产处理，否则经由重定向器的引用会让资产看起来仍被使用；空文件夹最后处理
+	if (Tasks.Contains(TEXT("Redirectors")))
+	{
+		RunRedirectorTask(SuperManagerModule, Report);
+	}
+	if (Tasks.Contains(TEXT("Unused")))
+	{
+		RunUnusedAssetTask(SuperManagerModule, Report);
+	}
+	if (Tasks.Contains(TEXT("EmptyFolders")))
+	{
+		RunEmptyFolderTask(Report);
+	}
+	if (Tasks.Contains(TEXT("SameName")))
+	{
+		RunSameNameTask(SuperManagerModule, Report);
+	}
+	if (Tasks.Contains(TEXT("IdenticalContent")))
+	{
+		RunIdenticalContentTask(SuperManagerModule, Report);
+	}
+
+	Report->SetNumberField(TEXT("failures"), NumFailures);
+
+	FString ReportString;
+	const TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&ReportString);
+	FJsonSerializer::Serialize(Report, JsonWriter);
+
+	if (!FFileHelper::SaveStringToFile(ReportString, *ReportFilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+	{
+		UE_LOG(LogSuperManagerCommandlet, Error, TEXT("Failed to write report to %s"), *ReportFilePath);
+		return 1;
+	}
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Report written to %s"), *ReportFilePath);
+	return NumFailures > 0 ? 1 : 0;
+}
+
+void USuperManagerCommandlet::RunRedirectorTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report)
+{
+	FRedirectorFixup& RedirectorFixup = SuperManagerModule.GetRedirectorFixup();
+
+	TArray<FAssetData> RedirectorsData;
+	RedirectorFixup.GatherRedirectorsInPaths(PackagePaths, RedirectorsData);
+
+	TArray<FString> RedirectorPackageNames;
+	for (const FAssetData& RedirectorData : RedirectorsData)
+	{
+		RedirectorPackageNames.Add(RedirectorData.PackageName.ToString());
+	}
+
+	TSharedRef<FJsonObject> RedirectorReport = MakeShared<FJsonObject>();
+	RedirectorReport->SetArrayField(TEXT("found"), MakeJsonStringArray(RedirectorPackageNames));
+
+	if (bApply && RedirectorsData.Num() > 0)
+	{
+		RedirectorFixup.FixUpRedirectorsInPaths(PackagePaths, FRedirectorFixup::FOnFixupCompleted());
+
+		// 没有编辑器主循环，手动推进异步加载和 Ticker（加载完成的批次在 Ticker 中修复），直到所有批次完成或超时
+		const double TimeoutTime = FPlatformTime::Seconds() + RedirectorTimeoutSeconds;
+		bool bTimedOut = false;
+		while (RedirectorFixup.IsRunning())
+		{
+			if (FPlatformTime::Seconds() > TimeoutTime)
+			{
+				UE_LOG(LogSuperManagerCommandlet, Error, TEXT("Redirector fixup timed out after %.0f seconds"), RedirectorTimeoutSeconds);
+				RedirectorFixup.Shutdown();
+				bTimedOut = true;
+				break;
+			}
+
+			FlushAsyncLoading();
+			FTSTicker::GetCoreTicker().Tick(0.f);
+		}
+
+		// 修复失败的重定向器不再出现在目录查询中，需要单独计入
+		TArray<FAssetData> RemainingRedirectorsData;
+		RedirectorFixup.GatherRedirectorsInPaths(PackagePaths, RemainingRedirectorsData);
+
+		TSet<FName> RemainingPackageNameSet;
+		for (const FAssetData& RedirectorData : RemainingRedirectorsData)
+		{
+			RemainingPackageNameSet.Add(RedirectorData.PackageName);
+		}
+
+		TArray<FString> RemainingPackageNames;
+		for (const FAssetData& RedirectorData : RedirectorsData)
+		{
+			if (RemainingPackageNameSet.Contains(RedirectorData.PackageName) || RedirectorFixup.IsRedirectorFailed(RedirectorData.PackageName))
+			{
+				RemainingPackageNames.Add(RedirectorData.PackageName.ToString());
+			}
+		}
+
+		NumFailures += RemainingPackageNames.Num() + (bTimedOut ? 1 : 0);
+		RedirectorReport->SetBoolField(TEXT("timedOut"), bTimedOut);
+		RedirectorReport->SetNumberField(TEXT("fixed"), RedirectorsData.Num() - RemainingPackageNames.Num());
+		RedirectorReport->SetArrayField(TEXT("failed"), MakeJsonStringArray(RemainingPackageNames));
+	}
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Redirectors: %d found"), RedirectorsData.Num());
+	Report->SetObjectField(TEXT("redirectors"), RedirectorReport);
+}
+
+void USuperManagerCommandlet::RunUnusedAssetTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report)
+{
+	TArray<TSharedPtr<FAssetData>> AssetsData;
+	GatherAssetsUnderPaths(AssetsData);
+
+	TArray<TSharedPtr<FAssetData>> UnusedAssetsData;
+	SuperManagerModule.ListUnusedAssetsForAssetList(AssetsData, UnusedAssetsData);
+
+	TArray<FString> UnusedObjectPaths;
+	TArray<FAssetData> AssetsDataToDelete;
+	for (const TSharedPtr<FAssetData>& UnusedAssetData : UnusedAssetsData)
+	{
+		UnusedObjectPaths.Add(UnusedAssetData->GetObjectPathString());
+		AssetsDataToDelete.Add(*UnusedAssetData);
+	}
+
+	TSharedRef<FJsonObject> UnusedReport = MakeShared<FJsonObject>();
+	UnusedReport->SetArrayField(TEXT("found"), MakeJsonStringArray(UnusedObjectPaths));
+
+	if (bApply && AssetsDataToDelete.Num() > 0)
+	{
+		FAssetDeletionOptions DeletionOptions;
+		DeletionOptions.bShowConfirmation = false;
+		DeletionOptions.bOnlyUnreferenced = true;
+
+		const TArray<EAssetDeletionResult> DeletionResults = FAssetDeletionService::DeleteAssets(AssetsDataToDelete,
+			SuperManagerModule.GetUpToDateAssetReferenceIndex(), DeletionOptions);
+
+		// 逐个记录没有删除成功的资产
+		TArray<FString> NotDeletedObjectPaths;
+		for (int32 AssetIndex = 0; AssetIndex < DeletionResults.Num(); ++AssetIndex)
+		{
+			if (DeletionResults[AssetIndex] != EAssetDeletionResult::Deleted)
+			{
+				NotDeletedObjectPaths.Add(AssetsDataToDelete[AssetIndex].GetObjectPathString());
+			}
+		}
+
+		const int32 NumDeleted = DeletionResults.Num() - NotDeletedObjectPaths.Num();
+		NumFailures += NotDeletedObjectPaths.Num();
+		UnusedReport->SetNumberField(TEXT("deleted"), NumDeleted);
+		UnusedReport->SetArrayField(TEXT("notDeleted"), MakeJsonStringArray(NotDeletedObjectPaths));
+	}
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Unused assets: %d found"), UnusedObjectPaths.Num());
+	Report->SetObjectField(TEXT("unusedAssets"), UnusedReport);
+}
+
+void USuperManagerCommandlet::RunEmptyFolderTask(const TSharedRef<FJsonObject>& Report)
+{
+	TArray<FName> EmptyFolderPaths;
+	for (const FString& PackagePath : PackagePaths)
+	{
+		TArray<FName> EmptyFolderPathsUnderPath;
+		FSuperManagerModule::FindEmptyFoldersUnder(FName(*PackagePath), PathExclusionMatcher, EmptyFolderPathsUnderPath);
+		EmptyFolderPaths.Append(EmptyFolderPathsUnderPath);
+	}
+
+	TArray<FString> EmptyFolderPathStrings;
+	for (const FName EmptyFolderPath : EmptyFolderPaths)
+	{
+		EmptyFolderPathStrings.Add(EmptyFolderPath.ToString());
+	}
+
+	TSharedRef<FJsonObject> EmptyFolderReport = MakeShared<FJsonObject>();
+	EmptyFolderReport->SetArrayField(TEXT("found"), MakeJsonStringArray(EmptyFolderPathStrings));
+
+	if (bApply && EmptyFolderPaths.Num() > 0)
+	{
+		TArray<FName> FailedFolderPaths;
+		const int32 NumDeleted = FSuperManagerModule::DeleteEmptyFolders(EmptyFolderPaths, FailedFolderPaths);
+
+		TArray<FString> FailedFolderPathStrings;
+		for (const FName FailedFolderPath : FailedFolderPaths)
+		{
+			FailedFolderPathStrings.Add(FailedFolderPath.ToString());
+		}
+
+		NumFailures += FailedFolderPaths.Num();
+		EmptyFolderReport->SetNumberField(TEXT("deleted"), NumDeleted);
+		EmptyFolderReport->SetArrayField(TEXT("failed"), MakeJsonStringArray(FailedFolderPathStrings));
+	}
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Empty folders: %d found"), EmptyFolderPaths.Num());
+	Report->SetObjectField(TEXT("emptyFolders"), EmptyFolderReport);
+}
+
+void USuperManagerCommandlet::RunSameNameTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report)
+{
+	TArray<TSharedPtr<FAssetData>> AssetsData;
+	GatherAssetsUnderPaths(AssetsData);
+
+	TArray<TSharedPtr<FAssetData>> SameNameAssetsData;
+	TArray<FAssetDataGroup> AssetGroups;
+	SuperManagerModule.ListSameNameAssetsForAssetList(AssetsData, SameNameAssetsData, AssetGroups);
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Same name groups: %d found"), AssetGroups.Num());
+	Report->SetArrayField(TEXT("sameNameGroups"), MakeJsonAssetGroups(SameNameAssetsData, AssetGroups));
+}
+
+void USuperManagerCommandlet::RunIdenticalContentTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report)
+{
+	TArray<TSharedPtr<FAssetData>> AssetsData;
+	GatherAssetsUnderPaths(AssetsData);
+
+	TArray<TSharedPtr<FAssetData>> IdenticalAssetsData;
+	TArray<FAssetDataGroup> AssetGroups;
+	SuperManagerModule.ListIdenticalContentAssetsForAssetList(AssetsData, IdenticalAssetsData, AssetGroups);
+
+	UE_LOG(LogSuperManagerCommandlet, Display, TEXT("Identical content groups: %d found"), AssetGroups.Num());
+	Report->SetArrayField(TEXT("identicalContentGroups"), MakeJsonAssetGroups(IdenticalAssetsData, AssetGroups));
+}
+
+/**
+ * @brief 用一次注册表查询取出所有路径下的资产，剔除重定向器和排除目录
+ */
+void USuperManagerCommandlet::GatherAssetsUnderPaths(TArray<TSharedPtr<FAssetData>>& OutAssetsData) const
+{
+	FARFilter Filter;
+	Filter.bRecursivePaths = true;
+	for (const FString& PackagePath : PackagePaths)
+	{
+		Filter.PackagePaths.Add(FName(*PackagePath));
+	}
+
+	TArray<FAssetData> AssetsData;
+	IAssetRegistry::GetChecked().GetAssets(Filter, AssetsData);
+
+	OutAssetsData.Reset(AssetsData.Num());
+	for (FAssetData& AssetData : AssetsData)
+	{
+		if (!AssetData.IsRedirector() && !PathExclusionMatcher.IsAssetExcluded(AssetData))
+		{
+			OutAssetsData.Add(MakeShared<FAssetData>(MoveTemp(AssetData)));
+		}
+	}
+}
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PackageContentHashCache.h"
+
+#include "Engine/Texture2D.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	/**
+	 * @brief 在新包中创建一张 4x4 的纹理并保存到磁盘
+	 * 压缩设置是枚举属性，导出数据中以名称下标保存，用来检查名称下标的规范化
+	 * @return 保存后的文件名，失败时返回空字符串
+	 */
+	FString SaveTestTexture(const FString& PackageName, FColor Color)
+	{
+		UPackage* Package = CreatePackage(*PackageName);
+		UTexture2D* Texture = NewObject<UTexture2D>(Package, FName(*FPackageName::GetShortName(PackageName)), RF_Public | RF_Standalone);
+
+		TArray<FColor> Pixels;
+		Pixels.Init(Color, 4 * 4);
+		Texture->Source.Init(4, 4, 1, 1, TSF_BGRA8, reinterpret_cast<const uint8*>(Pixels.GetData()));
+		Texture->CompressionSettings = TC_Normalmap;
+
+		const FString Filename = FPackageName::LongPackageNameToFilename(PackageName, FPackageName::GetAssetPackageExtension());
+
+		FSavePackageArgs SaveArgs;
+		SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+		SaveArgs.SaveFlags = SAVE_NoError;
+		const bool bSaved = UPackage::SavePackage(Package, Texture, *Filename, SaveArgs);
+
+		Texture->ClearFlags(RF_Public | RF_Standalone);
+		Texture->MarkAsGarbage();
+		Package->MarkAsGarbage();
+
+		return bSaved ? Filename : FString();
+	}
+}
+
+/**
+ * 同一张纹理以不同名称保存两份，资产名在排序后的名称表中分别位于其它名称之前和之后
+ * 两份的内容比较键必须相同；像素不同的纹理的键必须不同
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPackageContentHashCacheRenamedCopyTest, "SuperManager.PackageContentHashCache.RenamedCopy",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPackageContentHashCacheRenamedCopyTest::RunTest(const FString& Parameters)
+{
+	const TArray<FString> PackageNames = {
+		TEXT("/Temp/SuperManagerTests/AAA_Copy"),
+		TEXT("/Temp/SuperManagerTests/zzz_Copy"),
+		TEXT("/Temp/SuperManagerTests/AAA_Different"),
+	};
+	const FColor Colors[] = { FColor::Red, FColor::Red, FColor::Blue };
+
+	TArray<FName> PackageFNames;
+	TArray<FString> Filenames;
+	for (int32 PackageIndex = 0; PackageIndex < PackageNames.Num(); ++PackageIndex)
+	{
+		Filenames.Add(SaveTestTexture(PackageNames[PackageIndex], Colors[PackageIndex]));
+		PackageFNames.Add(FName(*PackageNames[PackageIndex]));
+	}
+
+	if (TestFalse(TEXT("All test textures saved"), Filenames.Contains(FString())))
+	{
+		FPackageContentHashCache PackageContentHashCache;
+		TArray<FPackageContentKey> ContentKeys;
+		PackageContentHashCache.ComputeContentKeys(PackageFNames, ContentKeys);
+
+		TestTrue(TEXT("Renamed copies are hashed"), ContentKeys[0].IsValid() && ContentKeys[1].IsValid());
+		TestTrue(TEXT("Renamed copies have the same content key"), ContentKeys[0] == ContentKeys[1]);
+		TestFalse(TEXT("Different pixels give a different content key"), ContentKeys[0] == ContentKeys[2]);
+	}
+
+	for (const FString& Filename : Filenames)
+	{
+		if (!Filename.IsEmpty())
+		{
+			IFileManager::Get().Delete(*Filename);
+		}
+	}
+
+	return true;
+}
+
+#endif
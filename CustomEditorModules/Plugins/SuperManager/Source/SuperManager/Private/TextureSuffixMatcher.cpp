@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TextureSuffixMatcher.h"
+
+void FTextureSuffixMatcher::Reset()
+{
+	ReversedSuffixTrieNodes.Reset();
+	ReversedSuffixTrieNodes.AddDefaulted();
+}
+
+/**
+ * @brief 把一组后缀编译进前缀树，同一个后缀出现在多组中时以先加入的为准
+ * @param Suffixes 后缀，如 _BaseColor
+ * @param Channel 这组后缀对应的通道
+ */
+void FTextureSuffixMatcher::AddSuffixes(const TArray<FString>& Suffixes, ETextureChannel Channel)
+{
+	if (ReversedSuffixTrieNodes.Num() == 0)
+	{
+		Reset();
+	}
+
+	for (const FString& Suffix : Suffixes)
+	{
+		// 空后缀不生效，否则所有纹理都会命中
+		if (Suffix.IsEmpty())
+		{
+			continue;
+		}
+
+		int32 NodeIndex = 0;
+		for (int32 CharIndex = Suffix.Len() - 1; CharIndex >= 0; --CharIndex)
+		{
+			const TCHAR Char = FChar::ToUpper(Suffix[CharIndex]);
+			if (const int32* ChildIndex = ReversedSuffixTrieNodes[NodeIndex].Children.Find(Char))
+			{
+				NodeIndex = *ChildIndex;
+			}
+			else
+			{
+				const int32 NewNodeIndex = ReversedSuffixTrieNodes.AddDefaulted();
+				ReversedSuffixTrieNodes[NodeIndex].Children.Add(Char, NewNodeIndex);
+				NodeIndex = NewNodeIndex;
+			}
+		}
+
+		if (ReversedSuffixTrieNodes[NodeIndex].Channel == ETextureChannel::None)
+		{
+			ReversedSuffixTrieNodes[NodeIndex].Channel = Channel;
+		}
+	}
+}
+
+/**
+ * @brief 按最长的后缀判断纹理对应的通道，名称只从末尾向前扫描一遍
+ * 后缀必须比名称短，整个名称就是后缀时不算命中
+ * @param TextureName 纹理名，如 T_Rock_BaseColor
+ * @param OutSuffixLength 命中的后缀长度，未命中时为 0
+ * @return 未命中任何后缀时返回 None
+ */
+ETextureChannel FTextureSuffixMatcher::Classify(FStringView TextureName, int32* OutSuffixLength) const
+{
+	ETextureChannel MatchedChannel = ETextureChannel::None;
+	int32 MatchedSuffixLength = 0;
+
+	int32 NodeIndex = ReversedSuffixTrieNodes.Num() > 0 ? 0 : INDEX_NONE;
+	for (int32 CharIndex = TextureName.Len() - 1; CharIndex > 0 && NodeIndex != INDEX_NONE; --CharIndex)
+	{
+		const int32* ChildIndex = ReversedSuffixTrieNodes[NodeIndex].Children.Find(FChar::ToUpper(TextureName[CharIndex]));
+		NodeIndex = ChildIndex ? *ChildIndex : INDEX_NONE;
+
+		if (NodeIndex != INDEX_NONE && ReversedSuffixTrieNodes[NodeIndex].Channel != ETextureChannel::None)
+		{
+			MatchedChannel = ReversedSuffixTrieNodes[NodeIndex].Channel;
+			MatchedSuffixLength = TextureName.Len() - CharIndex;
+		}
+	}
+
+	if (OutSuffixLength)
+	{
+		*OutSuffixLength = MatchedSuffixLength;
+	}
+	return MatchedChannel;
+}
@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "UnusedAssetScanTask.h"
+#include "AssetReferenceIndex.h"
+#include "DebugHeader.h"
+#include "PathExclusionMatcher.h"
+#include "Async/Async.h"
+
+FUnusedAssetScanTask::FUnusedAssetScanTask(TArray<FAssetData>&& InAssetsDataToScan, FAssetReferenceIndex& InReferenceIndex,
+	const FPathExclusionMatcher& InPathExclusionMatcher, const FOnScanCompleted& InOnScanCompleted)
+	: AssetsDataToScan(MoveTemp(InAssetsDataToScan))
+	, ReferenceIndex(InReferenceIndex)
+	, PathExclusionMatcher(InPathExclusionMatcher)
+	, OnScanCompleted(InOnScanCompleted)
+{
+}
+
+/**
+ * @brief 在游戏线程启动扫描
+ */
+void FUnusedAssetScanTask::Start()
+{
+	check(IsInGameThread());
+
+	bIsRunning = true;
+	bCancelRequested = false;
+
+	// Asset Manager 只能在游戏线程访问，索引需要新建时先在这里收集 PrimaryAssetId
+	if (!ReferenceIndex.IsBuilt())
+	{
+		PrimaryAssetReferencers = FAssetReferenceIndex::GatherPrimaryAssetReferencers();
+	}
+
+	TWeakPtr<FUnusedAssetScanTask> WeakTask = AsShared();
+	ProgressNotification = Debug::ShowProgressNotify(
+		TEXT("Scanning ") + FString::FromInt(AssetsDataToScan.Num()) + TEXT(" assets..."),
+		FSimpleDelegate::CreateLambda([WeakTask]()
+		{
+			if (TSharedPtr<FUnusedAssetScanTask> PinnedTask = WeakTask.Pin())
+			{
+				PinnedTask->Cancel();
+			}
+		}));
+
+	ScanFuture = Async(EAsyncExecution::ThreadPool, [SharedTask = AsShared()]()
+	{
+		SharedTask->Run();
+	});
+}
+
+void FUnusedAssetScanTask::Cancel()
+{
+	bCancelRequested = true;
+}
+
+/**
+ * @brief 取消并等待后台线程结束，模块卸载时使用
+ */
+void FUnusedAssetScanTask::CancelAndWait()
+{
+	Cancel();
+	if (ScanFuture.IsValid())
+	{
+		ScanFuture.Wait();
+	}
+}
+
+/**
+ * @brief 后台线程：确保索引最新，然后分块检查每个资产的引用数
+ */
+void FUnusedAssetScanTask::Run()
+{
+	if (!ReferenceIndex.IsBuilt())
+	{
+		PostProgress(TEXT("Building reference index..."));
+		ReferenceIndex.EnsureBuilt(PrimaryAssetReferencers);
+	}
+	ReferenceIndex.RefreshInvalidatedPackages();
+
+	const int32 NumAssets = AssetsDataToScan.Num();
+	for (int32 ChunkStart = 0; ChunkStart < NumAssets && !bCancelRequested; ChunkStart += ChunkSize)
+	{
+		const int32 ChunkEnd = FMath::Min(ChunkStart + ChunkSize, NumAssets);
+		for (int32 AssetIndex = ChunkStart; AssetIndex < ChunkEnd; ++AssetIndex)
+		{
+			const FAssetData& AssetData = AssetsDataToScan[AssetIndex];
+			if (PathExclusionMatcher.IsAssetExcluded(AssetData))
+			{
+				continue;
+			}
+
+			// 尚未保存、不在索引中的资产向注册表查询，与 Advance Deletion 和删除时的判断一致
+			if (ReferenceIndex.IsPackageUnused(AssetData.PackageName))
+			{
+				UnusedAssetsData.Add(AssetData);
+			}
+		}
+
+		PostProgress(TEXT("Scanned ") + FString::FromInt(ChunkEnd) + TEXT(" / ") + FString::FromInt(NumAssets) + TEXT(" assets"));
+	}
+
+	// 删除等操作必须在游戏线程进行
+	AsyncTask(ENamedThreads::GameThread, [WeakTask = TWeakPtr<FUnusedAssetScanTask>(AsShared())]()
+	{
+		if (TSharedPtr<FUnusedAssetScanTask> PinnedTask = WeakTask.Pin())
+		{
+			PinnedTask->Finish();
+		}
+	});
+}
+
+/**
+ * @brief 把进度文本投递到游戏线程更新通知
+ * @param ProgressText 进度文本
+ */
+void FUnusedAssetScanTask::PostProgress(const FString& ProgressText)
+{
+	AsyncTask(ENamedThreads::GameThread, [WeakTask = TWeakPtr<FUnusedAssetScanTask>(AsShared()), ProgressText]()
+	{
+		TSharedPtr<FUnusedAssetScanTask> PinnedTask = WeakTask.Pin();
+		if (PinnedTask.IsValid() && PinnedTask->bIsRunning && PinnedTask->ProgressNotification.IsValid())
+		{
+			PinnedTask->ProgressNotification->SetText(FText::FromString(ProgressText));
+		}
+	});
+}
+
+/**
+ * @brief 游戏线程：关闭进度通知，未取消时把结果交给回调
+ */
+void FUnusedAssetScanTask::Finish()
+{
+	check(IsInGameThread());
+
+	bIsRunning = false;
+
+	if (ProgressNotification.IsValid())
+	{
+		ProgressNotification->SetText(FText::FromString(bCancelRequested
+			? FString(TEXT("Unused asset scan cancelled"))
+			: TEXT("Found ") + FString::FromInt(UnusedAssetsData.Num()) + TEXT(" unused assets")));
+		ProgressNotification->SetCompletionState(bCancelRequested ? SNotificationItem::CS_Fail : SNotificationItem::CS_Success);
+		ProgressNotification->ExpireAndFadeout();
+		ProgressNotification.Reset();
+	}
+
+	if (!bCancelRequested)
+	{
+		OnScanCompleted.ExecuteIfBound(UnusedAssetsData);
+	}
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+class FAssetReferenceIndex;
+
+/**
+ * 单个资产的删除结果
+ */
+enum class EAssetDeletionResult : uint8
+{
+	Deleted,		// 已删除
+	Referenced,		// 仍被集合外的资产引用，按选项没有删除
+	Failed,			// 尝试删除但资产仍然存在，例如在删除对话框中被保留
+	Cancelled		// 用户取消，没有处理
+};
+
+struct FAssetDeletionOptions
+{
+	/** 删除前弹出一次汇总确认 */
+	bool bShowConfirmation = true;
+
+	/** 只删除未被引用的资产；为 false 时被引用的资产交给引擎的删除对话框处理 */
+	bool bOnlyUnreferenced = false;
+
+	/** 未引用的资产不加载，直接删除包文件；仍需加载的只有无法卸载的常驻包 */
+	bool bDeleteWithoutLoading = true;
+};
+
+/**
+ * 批量删除资产
+ * 先用反向依赖索引批量判断引用，只被集合内未引用资产引用的也视为未引用
+ * 未引用的资产按引用者在前的拓扑顺序分块删除，引用者总是与被引用者同块或在更早的块中
+ * 默认卸载常驻的包后直接删除包文件，不加载资产，再批量通知注册表
+ * 每块之后回收垃圾，内存占用与总数无关；结果按资产逐个返回
+ */
+class SUPERMANAGER_API FAssetDeletionService
+{
+public:
+	static TArray<EAssetDeletionResult> DeleteAssets(const TArray<FAssetData>& AssetsToDelete, const FAssetReferenceIndex& ReferenceIndex,
+		const FAssetDeletionOptions& Options = FAssetDeletionOptions());
+
+	static int32 CountResults(const TArray<EAssetDeletionResult>& Results, EAssetDeletionResult Result);
+
+private:
+	static void PartitionByReferences(const TArray<FAssetData>& AssetsToDelete, const FAssetReferenceIndex& ReferenceIndex,
+		TArray<int32>& OutUnreferencedIndices, TArray<int32>& OutReferencedIndices, TMap<FName, TArray<FName>>& OutInSetReferencers);
+	static void BuildDeletionBatches(const TArray<FAssetData>& AssetsToDelete, const TArray<int32>& UnreferencedIndices,
+		const TMap<FName, TArray<FName>>& InSetReferencers, TArray<TArray<int32>>& OutBatches);
+	static void DeleteBatchWithoutLoading(const TArray<FAssetData>& AssetsToDelete, const TArray<int32>& BatchIndices,
+		TArray<FAssetData>& OutAssetsDataToLoad);
+	static void UpdateResults(const TArray<FAssetData>& AssetsToDelete, const TArray<int32>& AssetIndices, TArray<EAssetDeletionResult>& InOutResults);
+
+	/** 每块加载和删除的资产数量 */
+	static constexpr int32 DeletionBatchSize = 256;
+};
@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetIdentifier.h"
+
+/**
+ * 可达性分析的根
+ * 规则从插件 Config 目录下的 DefaultSuperManager.ini 的 [Reachability] 读取：作为根的资产类型（默认为地图）、
+ * 是否把 Asset Manager 管理的 PrimaryAsset 作为根、是否把打包设置中总是烹饪的目录作为根，以及额外的根路径前缀
+ * /Game 以外的包（引擎、插件内容）不在清理范围内，总是作为根
+ */
+class SUPERMANAGER_API FAssetReachabilityRoots
+{
+public:
+	void LoadFromPluginConfig();
+
+	/** 在游戏线程收集根资产，Asset Manager 和打包设置都不是线程安全的 */
+	void GatherRootIdentifiers(TArray<FAssetIdentifier>& OutRootIdentifiers);
+
+	bool IsRootPackage(FName PackageName) const;
+
+private:
+	static bool IsPathUnderPrefix(FStringView Path, FStringView Prefix);
+
+	TArray<FTopLevelAssetPath> RootClassPaths;
+	TArray<FString> RootPathPrefixes;
+	bool bPrimaryAssetsAreRoots = true;
+	bool bAlwaysCookDirectoriesAreRoots = true;
+
+	/** 在 GatherRootIdentifiers 中读取打包设置得到，与 RootPathPrefixes 一起判断根包 */
+	TArray<FString> AlwaysCookPathPrefixes;
+};
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetIdentifier.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * 引用类型，与 Asset Registry 的依赖类别一一对应
+ */
+enum class EAssetReferenceKind : uint8
+{
+	Hard,				// Package 类别，硬引用
+	Soft,				// Package 类别，软引用
+	SearchableName,		// SearchableName 类别，如 DataTable 行名、GameplayTag
+	Management,			// Manage 类别，来自 Asset Manager 的 PrimaryAsset 管理关系
+	Num
+};
+
+/**
+ * 单个包的被引用计数，按引用类型分开统计
+ */
+struct FPackageReferencerCounts
+{
+	int32 Counts[static_cast<int32>(EAssetReferenceKind::Num)] = {};
+
+	int32 Get(EAssetReferenceKind Kind) const { return Counts[static_cast<int32>(Kind)]; }
+
+	/** 与 UEditorAssetLibrary::FindPackageReferencersForAsset 口径一致：只统计 Package 类别的硬引用和软引用 */
+	int32 GetPackageReferencerCount() const { return Get(EAssetReferenceKind::Hard) + Get(EAssetReferenceKind::Soft); }
+};
+
+/**
+ * 反向依赖索引
+ * 一次遍历 Asset Registry 的依赖图，得到 包名 -> 引用者数量 的映射，之后的查询都是 O(1) 的哈希查找
+ * 同时保存每个引用者的正向依赖边，包发生变化时只需要按包重算它自己的那部分边
+ * 建立和查询可以在任意线程进行，Asset Manager 相关的数据需要先在游戏线程收集
+ * 包的正向依赖边可以保存为二进制快照，下次启动时按包的保存哈希校验，只重新查询变化过的包
+ */
+class SUPERMANAGER_API FAssetReferenceIndex
+{
+public:
+	/** 在游戏线程收集 Manage 类别的引用者（PrimaryAssetId） */
+	static TArray<FAssetIdentifier> GatherPrimaryAssetReferencers();
+
+	/** Asset Manager 完成初始扫描后收集到的 PrimaryAssetId 才是完整的 */
+	static bool HasAssetManagerCompletedInitialScan();
+
+	void Build(const TArray<FAssetIdentifier>& PrimaryAssetReferencers);
+	void EnsureBuilt(const TArray<FAssetIdentifier>& PrimaryAssetReferencers);
+	void ReplacePrimaryAssetReferencers(const TArray<FAssetIdentifier>& PrimaryAssetReferencers);
+	void Reset();
+
+	bool LoadSnapshot(const FString& Filename, const TArray<FAssetIdentifier>& PrimaryAssetReferencers);
+	bool SaveSnapshot(const FString& Filename);
+
+	void InvalidatePackage(FName PackageName);
+	void RefreshInvalidatedPackages();
+
+	bool IsBuilt() const;
+	int32 NumIndexedPackages() const;
+
+	FPackageReferencerCounts GetReferencerCounts(FName PackageName) const;
+	int32 GetReferencerCount(FName PackageName, EAssetReferenceKind Kind) const;
+	bool IsPackageUnreferenced(FName PackageName) const;
+	bool IsPackageIndexed(FName PackageName) const;
+	bool TryGetIsPackageUnreferenced(FName PackageName, bool& bOutIsUnreferenced) const;
+	bool IsPackageUnused(FName PackageName) const;
+
+	void FindReachablePackages(const TArray<FAssetIdentifier>& RootIdentifiers, TFunctionRef<bool(FName PackageName)> IsRootPackage,
+		TSet<FName>& OutReachablePackageNames) const;
+
+private:
+	/** 一个引用者指向的所有包，按引用类型分开，每个包只出现一次 */
+	struct FReferenceEdges
+	{
+		TArray<FName> ReferencedPackageNames[static_cast<int32>(EAssetReferenceKind::Num)];
+	};
+
+	void Build_Locked(const TArray<FAssetIdentifier>& PrimaryAssetReferencers);
+	void QueryAndAddReferenceEdges_Locked(const TArray<FAssetIdentifier>& Referencers);
+	static TSet<FName> GatherAllPackageNames(const class IAssetRegistry& AssetRegistry);
+	static FReferenceEdges QueryReferenceEdges(const FAssetIdentifier& Referencer, const class IAssetRegistry& AssetRegistry);
+	void AddReferenceEdges(const FAssetIdentifier& Referencer, FReferenceEdges&& Edges);
+	void RemoveReferencesFrom(const FAssetIdentifier& Referencer);
+	void AddReference(FName ReferencedPackageName, EAssetReferenceKind Kind);
+	void RemoveReference(FName ReferencedPackageName, EAssetReferenceKind Kind);
+
+	/** 建立索引时每个工作线程任务处理的引用者数量 */
+	static constexpr int32 BuildChunkSize = 512;
+
+	/** 快照文件格式版本，格式变化时递增，旧快照会被忽略 */
+	static constexpr uint32 SnapshotMagic = 0x534D5249;	// "SMRI"
+	static constexpr uint32 SnapshotVersion = 1;
+
+	/** 保护计数和依赖边 */
+	mutable FRWLock IndexLock;
+	TMap<FName, FPackageReferencerCounts> ReferencerCountsMap;
+	TMap<FAssetIdentifier, FReferenceEdges> ForwardEdgesMap;
+	bool bIsBuilt = false;
+
+	/** 注册表事件在游戏线程标记失效的包，单独加锁，避免建立索引期间阻塞游戏线程 */
+	FCriticalSection InvalidatedPackagesLock;
+	TSet<FName> InvalidatedPackageNames;
+};
@@ -34,10 +34,50 @@ namespace Debug
 
 	static void ShowNotifyInfo(const FString& Message)
 	{
+		// 命令行工具中没有 Slate，改为写入日志
+		if (IsRunningCommandlet())
+		{
+			PrintLog(Message);
+			return;
+		}
+
 		FNotificationInfo NotifyInfo(FText::FromString(Message));
 		NotifyInfo.bUseLargeFont = true;
 		NotifyInfo.FadeOutDuration = 7.f;
 
 		FSlateNotificationManager::Get().AddNotification(NotifyInfo);
 	}
+
+	/**
+	 * @brief 显示一个常驻的进度通知，带取消按钮，需要调用者在任务结束时调用 ExpireAndFadeout
+	 * @param Message 初始文本，之后可通过 SetText 更新进度
+	 * @param OnCancelClicked 点击取消按钮的回调
+	 * @return 通知项
+	 */
+	static TSharedPtr<SNotificationItem> ShowProgressNotify(const FString& Message, const FSimpleDelegate& OnCancelClicked)
+	{
+		if (IsRunningCommandlet())
+		{
+			PrintLog(Message);
+			return nullptr;
+		}
+
+		FNotificationInfo NotifyInfo(FText::FromString(Message));
+		NotifyInfo.bUseLargeFont = true;
+		NotifyInfo.FadeOutDuration = 7.f;
+		NotifyInfo.bFireAndForget = false;
+		NotifyInfo.bUseThrobber = true;
+		NotifyInfo.ButtonDetails.Add(FNotificationButtonInfo(
+			FText::FromString(TEXT("Cancel")),
+			FText::FromString(TEXT("Cancel the running task")),
+			OnCancelClicked,
+			SNotificationItem::CS_Pending));
+
+		TSharedPtr<SNotificationItem> NotifyItem = FSlateNotificationManager::Get().AddNotification(NotifyInfo);
+		if (NotifyItem.IsValid())
+		{
+			NotifyItem->SetCompletionState(SNotificationItem::CS_Pending);
+		}
+		return NotifyItem;
+	}
 }
\ No newline at end of file
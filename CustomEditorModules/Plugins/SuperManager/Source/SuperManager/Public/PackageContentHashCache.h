@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Async/Future.h"
+#include <atomic>
+
+/**
+ * 包内容的比较键
+ * 导出数据按下标引用名称表和导入表，所以名称表和导入表也参与比较；包名和资产名在名称表中替换为占位符
+ * 名称表按替换后的字符串排序，导出数据中的名称下标改写为排序后的下标，改名后的副本与原包得到相同的键
+ * 导出数据之后的 BulkData 和包尾按原样比较
+ */
+struct FPackageContentKey
+{
+	int64 PayloadSize = INDEX_NONE;
+	uint64 PayloadHash = 0;
+	bool bHasPayloadHash = false;
+
+	/** 只有计算过哈希的键才参与比较，长度唯一的包不会被读取 */
+	bool IsValid() const { return bHasPayloadHash; }
+
+	bool operator==(const FPackageContentKey& Other) const
+	{
+		return PayloadSize == Other.PayloadSize && PayloadHash == Other.PayloadHash;
+	}
+
+	friend uint32 GetTypeHash(const FPackageContentKey& Key)
+	{
+		return HashCombine(GetTypeHash(Key.PayloadSize), GetTypeHash(Key.PayloadHash));
+	}
+};
+
+/**
+ * 包文件内容哈希的缓存
+ * 按文件大小和修改时间判断缓存是否有效，重新扫描时只读取发生变化的包
+ * 读取和哈希计算分散到工作线程，只对内容长度与其它包相同的包计算哈希
+ */
+class SUPERMANAGER_API FPackageContentHashCache
+{
+public:
+	~FPackageContentHashCache();
+
+	void ComputeContentKeys(const TArray<FName>& PackageNames, TArray<FPackageContentKey>& OutContentKeys,
+		const std::atomic<bool>* bCancelRequested = nullptr);
+	void ComputeContentKeysAsync(TArray<FName>&& PackageNames, TFunction<void(TArray<FPackageContentKey>&& ContentKeys)>&& OnCompleted);
+	void CancelAndWait();
+	void Reset();
+
+private:
+	struct FCachedPackageContent
+	{
+		int64 FileSize = INDEX_NONE;
+		FDateTime ModificationTime;
+		int64 PayloadOffset = INDEX_NONE;
+		uint64 PayloadHash = 0;
+		bool bHasPayloadHash = false;
+	};
+
+	static bool ResolvePackageFilename(FName PackageName, FString& OutFilename, struct FFileStatData& OutStatData);
+	static int64 ReadPayloadOffset(const FString& Filename, int64 FileSize);
+	static bool HashPackageContent(const FString& Filename, FName PackageName, int64 PayloadOffset, uint64& OutPayloadHash);
+
+	FCriticalSection CacheLock;
+	TMap<FName, FCachedPackageContent> CachedPackages;
+
+	/** 后台计算，只有最后一个未被取消，被取消的计算尽快结束，不等待它们 */
+	TArray<TFuture<void>> ComputeFutures;
+	TSharedPtr<std::atomic<bool>> RunningCancelFlag;
+};
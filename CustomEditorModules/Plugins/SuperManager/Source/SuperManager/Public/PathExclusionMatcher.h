@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FAssetData;
+
+/**
+ * 路径排除规则
+ * 规则从插件 Config 目录下的 DefaultSuperManager.ini 读取，编译成以 FName 为节点的路径前缀树
+ * 匹配时按 '/' 逐级切分路径，每一级只做一次 FName 查找，不分配字符串，耗时与规则数量无关
+ */
+class SUPERMANAGER_API FPathExclusionMatcher
+{
+public:
+	void LoadFromPluginConfig(const TArray<FString>& AdditionalFolderNames = {}, const TArray<FString>& AdditionalPathPrefixes = {});
+	void Compile(const TArray<FString>& InExcludedFolderNames, const TArray<FString>& InExcludedPathPrefixes);
+
+	bool IsFolderExcluded(FStringView FolderPath) const;
+	bool IsFolderExcluded(FName FolderPath) const;
+	bool IsAssetExcluded(const FAssetData& AssetData) const;
+
+private:
+	struct FTrieNode
+	{
+		TMap<FName, int32> Children;
+		bool bExcluded = false;
+	};
+
+	static FName FindSegmentName(FStringView Segment);
+
+	/** 任意一级文件夹同名即排除 */
+	TSet<FName> ExcludedFolderNames;
+
+	/** 从根开始逐级匹配的前缀树，0 号节点为根 */
+	TArray<FTrieNode> PrefixTrieNodes;
+};
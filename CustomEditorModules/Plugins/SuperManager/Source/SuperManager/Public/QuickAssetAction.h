@@ -55,5 +55,5 @@ private:
 		{UNiagaraEmitter::StaticClass(), TEXT("NE_")}
 	};
 
-	void FixUpRedirectors();
+	static void RemoveUnusedAssetsAmong(const TArray<FAssetData>& SelectedAssetsData);
 };
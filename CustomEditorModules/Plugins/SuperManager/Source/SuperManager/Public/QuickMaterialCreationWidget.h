@@ -4,6 +4,9 @@
 
 #include "CoreMinimal.h"
 #include "EditorUtilityWidget.h"
+#include "Engine/TextureDefines.h"
+#include "Materials/MaterialInterface.h"
+#include "TextureSuffixMatcher.h"
 #include "QuickMaterialCreationWidget.generated.h"
 
 UENUM(BlueprintType)
@@ -14,6 +17,16 @@ enum class E_ChannelPackingType : uint8
 	ECPT_MAX UMETA(DisplayName = "DefaultMax")
 };
 
+/**
+ * 同一套贴图：同一文件夹下去掉前缀和通道后缀后同名的纹理
+ */
+struct FMaterialTextureSet
+{
+	FString PackagePath;
+	FString BaseName;
+	TArray<FAssetData> TexturesData;
+};
+
 /**
  * 
  */
@@ -42,6 +55,52 @@ public:
 
 #pragma endregion
 
+#pragma region BatchMaterialCreation
+
+	UFUNCTION(BlueprintCallable)
+	void CreateMaterialsFromTextureSets();
+
+	/** 为 true 时处理文件夹下（含子文件夹）的所有纹理，否则处理所选纹理 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CreateMaterialsFromTextureSets")
+	bool bUseTextureFolder = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "CreateMaterialsFromTextureSets", meta = (EditCondition = "bUseTextureFolder"))
+	FString TextureFolderPath = TEXT("/Game");
+
+#pragma endregion
+
+#pragma region MasterMaterial
+
+	/** 为 true 时不再创建材质，只为通道打包方式对应的母材质创建材质实例并设置纹理参数，不产生新的着色器排列 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial")
+	bool bUseMasterMaterial = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial", meta = (EditCondition = "bUseMasterMaterial"))
+	TSoftObjectPtr<UMaterialInterface> NoChannelPackingMasterMaterial;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial", meta = (EditCondition = "bUseMasterMaterial"))
+	TSoftObjectPtr<UMaterialInterface> ORMMasterMaterial;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial|Texture Parameter Names", meta = (EditCondition = "bUseMasterMaterial"))
+	FName BaseColorParameterName = TEXT("BaseColor");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial|Texture Parameter Names", meta = (EditCondition = "bUseMasterMaterial"))
+	FName MetallicParameterName = TEXT("Metallic");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial|Texture Parameter Names", meta = (EditCondition = "bUseMasterMaterial"))
+	FName RoughnessParameterName = TEXT("Roughness");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial|Texture Parameter Names", meta = (EditCondition = "bUseMasterMaterial"))
+	FName NormalParameterName = TEXT("Normal");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial|Texture Parameter Names", meta = (EditCondition = "bUseMasterMaterial"))
+	FName AmbientOcclusionParameterName = TEXT("AmbientOcclusion");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "MasterMaterial|Texture Parameter Names", meta = (EditCondition = "bUseMasterMaterial"))
+	FName ORMParameterName = TEXT("ORM");
+
+#pragma endregion
+
 #pragma region SupportedTextureNames
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Supported Texture Names")
@@ -96,26 +155,61 @@ public:
 private:
 #pragma region QuickMaterialCreation
 
-	bool ProcessSelectedData(const TArray<FAssetData>& SelectedDataToProcess, TArray<UTexture2D*>& OutSelectedTexturesArray, FString& OutSelectedTexturePackagePath);
+	bool ProcessSelectedData(const TArray<FAssetData>& SelectedDataToProcess, TArray<FAssetData>& OutSelectedTexturesData, FString& OutSelectedTexturePackagePath);
+	bool CanTextureBeBound(const FString& TextureName) const;
+	void EnsureTextureSuffixMatcherUpToDate();
+	void LoadTexturesToBind(const TArray<FAssetData>& TexturesData, TArray<UTexture2D*>& OutTextures) const;
 	bool CheckIsNameUsed(const FString& FolderPathToCheck, const FString& MaterialNameToCheck);
 	UMaterial* CreateMaterialAsset(const FString& NameOfMaterial, const FString& PathToPutMaterial);
 	void Default_CreateMaterialNodes(UMaterial* CreatedMaterial, UTexture2D* SelectedTexture, uint32& PinsConnectedCounter);
 	void ORM_CreateMaterialNodes(UMaterial* CreatedMaterial, UTexture2D* SelectedTexture, uint32& PinsConnectedCounter);
+	void ConnectTexturesToMaterial(UMaterial* CreatedMaterial, const TArray<UTexture2D*>& Textures, uint32& PinsConnectedCounter);
+
+#pragma endregion
+
+
+#pragma region BatchMaterialCreation
+
+	void GatherTextureSets(const TArray<FAssetData>& TexturesData, TArray<FMaterialTextureSet>& OutTextureSets) const;
+	FString GetTextureSetBaseName(const FString& TextureName) const;
+	bool CreateMaterialForTextureSet(const FMaterialTextureSet& TextureSet, TArray<UPackage*>& OutCreatedPackages,
+		TSet<FString>& InOutCreatedObjectPaths);
+	static UObject* CreateAssetInNewPackage(const FString& AssetName, const FString& PackagePath, UClass* AssetClass, class UFactory* Factory);
+
+#pragma endregion
+
+
+#pragma region MasterMaterial
+
+	UMaterialInterface* GetMasterMaterial();
+	void CreateMasterMaterialInstance(const TArray<FAssetData>& TexturesData, FString& PathToPutMI);
+	FName GetTextureParameterName(ETextureChannel TextureChannel) const;
+	void SetMasterMaterialTextureParameters(class UMaterialInstanceConstant* MaterialInstance, const TArray<UTexture2D*>& Textures, uint32& ParametersSetCounter);
+
+	/** 已加载的母材质，按软引用路径缓存，批量创建时每种通道打包方式只加载一次 */
+	UPROPERTY(Transient)
+	TMap<FSoftObjectPath, TObjectPtr<UMaterialInterface>> CachedMasterMaterials;
 
 #pragma endregion
 
 
 #pragma region CreateMaterialNodesConnectPins
 
-	bool TryConnectBaseColorSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
-	bool TryConnectMetallicSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
-	bool TryConnectRoughnessSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
-	bool TryConnectNormalSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
-	bool TryConnectAOSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
-	bool TryConnectORMSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	void ConnectBaseColorSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	void ConnectMetallicSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	void ConnectRoughnessSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	void ConnectNormalSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	void ConnectAOSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	void ConnectORMSocket(UMaterialExpressionTextureSample* TextureSampleNode, UTexture2D* SelectedTexture, UMaterial* CreatedMaterial);
+	static void SetLinearTextureSettings(UTexture2D* SelectedTexture, TextureCompressionSettings CompressionSettings);
 
 #pragma endregion
 
-	class UMaterialInstanceConstant* CreateMaterialInstanceAsset(UMaterial* ParentMaterial, FString& NameOfMaterialInstance, FString& PathToPutMI);
+	/** 由 Supported Texture Names 中的后缀表编译而成 */
+	FTextureSuffixMatcher TextureSuffixMatcher;
+	uint32 CompiledSuffixTablesHash = 0;
+	bool bTextureSuffixMatcherCompiled = false;
+
+	class UMaterialInstanceConstant* CreateMaterialInstanceAsset(UMaterialInterface* ParentMaterial, FString& NameOfMaterialInstance, FString& PathToPutMI);
 	
 };
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "UObject/UObjectGlobals.h"
+#include "Containers/Ticker.h"
+
+class SNotificationItem;
+
+/**
+ * 重定向器修复
+ * 只修复与给定目录相关的重定向器：位于目录下的，以及指向目录下资产的
+ * 已知的重定向器由注册表事件维护，没有新的重定向器时直接跳过
+ * 重定向器按引用者包分批，每批异步加载、签出引用者、修复并保存，批与批之间可以取消
+ * 一批加载完成后在下一帧的 Ticker 中修复，加载回调只做计数
+ * 尚未完成的重定向器记录在 Saved/SuperManager 下，崩溃或取消后下次修复时继续
+ */
+class SUPERMANAGER_API FRedirectorFixup
+{
+public:
+	DECLARE_DELEGATE(FOnFixupCompleted);
+
+	bool FixUpRedirectorsInPaths(const TArray<FString>& PackagePaths, const FOnFixupCompleted& OnCompleted);
+	void GatherRedirectorsInPaths(const TArray<FString>& PackagePaths, TArray<FAssetData>& OutRedirectorsData);
+	bool IsRunning() const { return bIsRunning; }
+	bool IsRedirectorFailed(FName PackageName) const { return FailedRedirectorPackageNames.Contains(PackageName); }
+	void Cancel();
+	bool Reset();
+	void Shutdown();
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+
+private:
+	/** 一批重定向器和它们的引用者包，同一批的引用者只签出和保存一次 */
+	struct FFixupBatch
+	{
+		TArray<FAssetData> RedirectorsData;
+		TArray<FName> ReferencerPackageNames;
+	};
+
+	void GatherKnownRedirectors();
+	void GatherRedirectorsInScope(const TArray<FString>& PackagePaths, TArray<FAssetData>& OutRedirectorsData) const;
+	void GatherResumedRedirectors(TArray<FAssetData>& InOutRedirectorsData) const;
+	void BuildFixupBatches(TArray<FAssetData>&& RedirectorsData);
+
+	void StartNextBatch();
+	void OnRedirectorPackageLoaded(const FName& PackageName, UPackage* LoadedPackage, EAsyncLoadingResult::Type Result, uint32 FixupRunId);
+	bool ProcessLoadedBatch(float DeltaTime);
+	void FixUpCurrentBatch();
+	void Finish();
+	void ResetState();
+
+	static FString GetResumeFilePath();
+	void SaveResumeFile() const;
+
+	/** 每批最多涉及的引用者包数量，限制单次签出和保存的规模 */
+	static constexpr int32 MaxReferencerPackagesPerBatch = 64;
+
+	/** 包名 -> 重定向器数据 */
+	TMap<FName, FAssetData> KnownRedirectors;
+	bool bKnownRedirectorsGathered = false;
+
+	/** 上次修复失败的重定向器（例如签出被拒绝），重新添加之前不会自动重试 */
+	TSet<FName> FailedRedirectorPackageNames;
+
+	TArray<FFixupBatch> FixupBatches;
+	int32 CurrentBatchIndex = 0;
+	int32 NumPendingLoads = 0;
+
+	/** 一批加载完成后在下一帧处理，不在异步加载回调中修复、签出、保存和回收垃圾 */
+	FTSTicker::FDelegateHandle ProcessBatchTickerHandle;
+	FOnFixupCompleted OnFixupCompleted;
+	TSharedPtr<SNotificationItem> ProgressNotification;
+	bool bIsRunning = false;
+	bool bCancelRequested = false;
+
+	/** 每次修复递增，Reset 之后尚未返回的异步加载回调会被忽略 */
+	uint32 CurrentFixupRunId = 0;
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+/**
+ * 资产分组（同名、内容相同等），组内资产在结果数组中占据 [StartIndex, StartIndex + Num) 的连续区间
+ */
+struct FAssetDataGroup
+{
+	FName GroupName;
+	int32 StartIndex = 0;
+	int32 Num = 0;
+};
+
+/**
+ * Advance Deletion 列表的数据模型
+ * 所有资产数据保存在一个连续的 TArray<FAssetData> 中，列表项只是指向其中元素的别名指针，按下标定位
+ * 勾选状态和删除状态都保存在与资产数组等长的位数组中，被删除的资产不会从数组中移除，保证下标稳定
+ * 磁盘大小按需统计：请求的下标攒成一批，在线程池中一次读取文件大小，结果按下标缓存，列表刷新后仍然有效
+ */
+class SUPERMANAGER_API FAdvanceDeletionListModel : public TSharedFromThis<FAdvanceDeletionListModel>
+{
+public:
+	explicit FAdvanceDeletionListModel(TArray<FAssetData>&& InAssetsData);
+
+	int32 Num() const { return AssetsData.Num(); }
+	const FAssetData& GetAssetData(int32 Index) const { return AssetsData[Index]; }
+	const TArray<FAssetData>& GetAllAssetsData() const { return AssetsData; }
+
+	TSharedPtr<FAssetData> MakeItem(int32 Index);
+	void MakeAllItems(TArray<TSharedPtr<FAssetData>>& OutItems);
+	int32 GetItemIndex(const TSharedPtr<FAssetData>& Item) const;
+
+#pragma region CheckState
+
+	bool IsChecked(int32 Index) const { return CheckedBits[Index]; }
+	void SetChecked(int32 Index, bool bChecked) { CheckedBits[Index] = bChecked; }
+	void SetItemsChecked(const TArray<TSharedPtr<FAssetData>>& Items, bool bChecked);
+	void ClearAllChecked();
+	int32 NumChecked() const { return CheckedBits.CountSetBits(); }
+	void GetCheckedIndices(TArray<int32>& OutIndices) const;
+	void GetCheckedAssetsData(TArray<FAssetData>& OutAssetsData) const;
+
+#pragma endregion
+
+#pragma region Removal
+
+	void MarkRemoved(int32 Index);
+	bool IsItemRemoved(const TSharedPtr<FAssetData>& Item) const;
+
+#pragma endregion
+
+#pragma region AssetSize
+
+	void RequestDiskSize(int32 Index);
+	void RequestDiskSizes(const TArray<TSharedPtr<FAssetData>>& Items);
+	bool HasDiskSize(int32 Index) const { return DiskSizes[Index] != INDEX_NONE; }
+	int64 GetDiskSize(int32 Index) const { return DiskSizes[Index]; }
+	int64 GetResourceSize(int32 Index) const;
+	int64 GetCheckedDiskSize(int32& OutNumUnknown) const;
+
+	/** 每批磁盘大小统计完成后在游戏线程调用 */
+	FSimpleDelegate OnDiskSizesGathered;
+
+#pragma endregion
+
+private:
+	void StartDiskSizeTask();
+
+	TArray<FAssetData> AssetsData;
+
+	/** 勾选状态由模型按下标保存，与行控件的生成和回收无关 */
+	TBitArray<> CheckedBits;
+
+	/** 已经从磁盘删除的资产 */
+	TBitArray<> RemovedBits;
+
+	/** 包文件大小，INDEX_NONE 表示尚未统计 */
+	TArray<int64> DiskSizes;
+	TBitArray<> DiskSizeRequestedBits;
+	TArray<int32> PendingDiskSizeIndices;
+	bool bDiskSizeTaskQueued = false;
+
+	/** 常驻内存资产的估算资源大小，INDEX_NONE 表示尚未计算 */
+	mutable TArray<int64> ResourceSizes;
+};
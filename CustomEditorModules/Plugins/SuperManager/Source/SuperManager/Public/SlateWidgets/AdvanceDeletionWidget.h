@@ -3,13 +3,38 @@
 #pragma once
 
 #include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/STreeView.h"
+#include "SlateWidgets/AdvanceDeletionListModel.h"
+
+class SWidgetSwitcher;
+
+/**
+ * 分组视图的分组方式
+ */
+enum class EAssetGroupingMode : uint8
+{
+	None,				// 平铺列表
+	SameName,			// 同名资产
+	IdenticalContent	// 磁盘内容相同的资产
+};
+
+/**
+ * 同名分组视图的树节点，组头节点没有 AssetData，子节点指向具体资产
+ */
+struct FAssetGroupTreeItem
+{
+	int32 GroupIndex = INDEX_NONE;
+	FName GroupName;
+	TSharedPtr<FAssetData> AssetData;
+	TArray<TSharedPtr<FAssetGroupTreeItem>> Children;
+};
 
 class SAdvanceDeletionTab : public SCompoundWidget
 {
 	SLATE_BEGIN_ARGS(SAdvanceDeletionTab) {}
 
 	// 定义 Widget 参数的类型和名称，在构造时传入
-	SLATE_ARGUMENT(TArray<TSharedPtr<FAssetData>>, AssetsDataToStore)
+	SLATE_ARGUMENT(TSharedPtr<FAdvanceDeletionListModel>, AssetListModel)
 	SLATE_ARGUMENT(FString, CurrentSelectedFolder)
 	
 	SLATE_END_ARGS()
@@ -18,14 +43,13 @@ public:
 	void Construct(const FArguments& InArgs);
 
 private:
+	TSharedPtr<FAdvanceDeletionListModel> AssetListModel;
 	TArray<TSharedPtr<FAssetData>> StoredAssetsData;
 	TArray<TSharedPtr<FAssetData>> DisplayedAssetsData;
-	TArray<TSharedPtr<FAssetData>> AssetDataToDeleteArray;
-	
-	TArray<TSharedRef<SCheckBox>> CheckBoxesArray;
 
 	TSharedRef<SListView<TSharedPtr<FAssetData>>> ConstructAssetListView();
 	TSharedPtr<SListView<TSharedPtr<FAssetData>>> ConstructedAssetListView;
+	void RemoveDeletedItems();
 	void RefreshAssetListView();
 
 	FSlateFontInfo GetEmbossedTextFont() const
@@ -36,7 +60,10 @@ private:
 #pragma region RowWidgetForAssetListView
 	
 	TSharedRef<ITableRow> OnGenerateRowForList(TSharedPtr<FAssetData> AssetDataToDisplay, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<SWidget> ConstructRowContent(const TSharedPtr<FAssetData>& AssetDataToDisplay);
+	TSharedRef<SWidget> ConstructCellForColumn(const FName& ColumnId, TSharedPtr<FAssetData> AssetDataToDisplay);
 	TSharedRef<SCheckBox> ConstructCheckBox(const TSharedPtr<FAssetData>& AssetDataToDisplay);
+	ECheckBoxState GetCheckBoxState(TSharedPtr<FAssetData> AssetData) const;
 	void OnCheckBoxStateChanged(ECheckBoxState NewState, TSharedPtr<FAssetData> AssetData);
 	TSharedRef<STextBlock> ConstructTextForRowWidget(const FString& TextContent, const FSlateFontInfo& FontToUse);
 	TSharedRef<SButton> ConstructButtonForRowWidget(const TSharedPtr<FAssetData>& AssetDataToDisplay);
@@ -46,6 +73,46 @@ private:
 #pragma endregion
 
 
+#pragma region AssetListColumns
+
+	TSharedRef<SHeaderRow> ConstructAssetListHeaderRow();
+	EColumnSortMode::Type GetColumnSortMode(FName ColumnId) const;
+	void OnColumnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type InSortMode);
+	void SortDisplayedAssets();
+	void OnDiskSizesGathered();
+
+	FText GetDiskSizeText(TSharedPtr<FAssetData> AssetData) const;
+	FText GetResourceSizeText(TSharedPtr<FAssetData> AssetData) const;
+	FText GetSelectionSummaryText() const;
+
+	FName SortColumnId;
+	EColumnSortMode::Type SortMode = EColumnSortMode::None;
+
+#pragma endregion
+
+
+#pragma region AssetGroupView
+
+	TSharedRef<STreeView<TSharedPtr<FAssetGroupTreeItem>>> ConstructAssetGroupTreeView();
+	TSharedPtr<STreeView<TSharedPtr<FAssetGroupTreeItem>>> ConstructedAssetGroupTreeView;
+	TSharedPtr<SWidgetSwitcher> AssetViewSwitcher;
+
+	TArray<FAssetDataGroup> AssetGroups;
+	TArray<TSharedPtr<FAssetGroupTreeItem>> AssetGroupTreeRootItems;
+	EAssetGroupingMode AssetGroupingMode = EAssetGroupingMode::None;
+
+	/** 每次请求内容比较时递增，只接受最后一次请求的结果 */
+	uint32 IdenticalContentRequestId = 0;
+
+	void ListGroupedAssets(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter);
+	void RebuildAssetGroupTreeItems();
+	TSharedRef<ITableRow> OnGenerateRowForAssetGroupTree(TSharedPtr<FAssetGroupTreeItem> Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnGetAssetGroupTreeChildren(TSharedPtr<FAssetGroupTreeItem> Item, TArray<TSharedPtr<FAssetGroupTreeItem>>& OutChildren);
+	void OnAssetGroupTreeMouseButtonClicked(TSharedPtr<FAssetGroupTreeItem> ClickedItem);
+
+#pragma endregion
+
+
 #pragma region TabButtons
 	
 	TSharedRef<SButton> ConstructDeleteAllButton();
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "Widgets/SCompoundWidget.h"
+
+class SWindow;
+
+/**
+ * 列出文件夹并请求确认的模态对话框
+ * 文件夹列表是虚拟化的 SListView，只生成可见的行，数万个文件夹也能流畅滚动
+ */
+class SFolderListConfirmDialog : public SCompoundWidget
+{
+	SLATE_BEGIN_ARGS(SFolderListConfirmDialog) {}
+
+	SLATE_ARGUMENT(FString, Message)
+	SLATE_ARGUMENT(TArray<FName>, FolderPaths)
+	SLATE_ARGUMENT(TSharedPtr<SWindow>, ParentWindow)
+
+	SLATE_END_ARGS()
+
+public:
+	void Construct(const FArguments& InArgs);
+
+	static bool ShowModal(const FString& Title, const FString& Message, TArray<FName>&& FolderPaths);
+
+	bool IsConfirmed() const { return bConfirmed; }
+
+private:
+	TArray<FName> FolderPaths;
+	TArray<TSharedPtr<FName>> FolderPathItems;
+	TWeakPtr<SWindow> ParentWindow;
+	bool bConfirmed = false;
+
+	TSharedRef<ITableRow> OnGenerateRowForFolderList(TSharedPtr<FName> FolderPath, const TSharedRef<STableViewBase>& OwnerTable);
+	FReply OnConfirmButtonClicked();
+	FReply OnCancelButtonClicked();
+};
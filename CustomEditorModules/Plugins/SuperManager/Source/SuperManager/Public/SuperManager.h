@@ -4,6 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "Modules/ModuleManager.h"
+#include "Async/Future.h"
+#include "AssetDeletionService.h"
+#include "AssetReachabilityRoots.h"
+#include "AssetReferenceIndex.h"
+#include "PathExclusionMatcher.h"
+#include "PackageContentHashCache.h"
+#include "RedirectorFixup.h"
 
 class FSuperManagerModule : public IModuleInterface
 {
@@ -18,15 +25,21 @@ private:
 	void InitCBMenuExtention();
 	
 	TArray<FString> FolderPathsSelected;
+
+	/** 点击 Advance Deletion 时所选的目录，修复重定向器期间所选目录可能已经改变 */
+	TArray<FString> AdvanceDeletionFolderPaths;
 	
 	TSharedRef<FExtender> CustomCBMenuExtender(const TArray<FString>& SelectedPaths);
 	void AddCBMenuEntry(class FMenuBuilder& MenuBuilder);
 	
 	void OnDeleteUnusedAssetsButtonClicked();
+	void StartUnusedAssetScan(TArray<FAssetData>&& AssetsDataToScan);
+	void OnUnusedAssetScanCompleted(const TArray<FAssetData>& UnusedAssetsData);
 	void OnDeleteEmptyFoldersButtonClicked();
+	void DeleteEmptyFoldersUnderSelectedFolder(FString SelectedFolderPath);
 	void OnAdvanceDeletionButtonClicked();
 
-	void FixUpRedirectors();
+	FPathExclusionMatcher PathExclusionMatcher;
 #pragma endregion
 
 #pragma region CustomEditorTab
@@ -35,18 +48,93 @@ private:
 
 	TSharedRef<SDockTab> OnSpawnAdvanceDeletionTab(const FSpawnTabArgs& TabArgs);
 
-	TArray<TSharedPtr<FAssetData>> GetAllAssetDataUnderSelectedFolder();
+	TSharedRef<class FAdvanceDeletionListModel> GetAllAssetDataUnderSelectedFolder();
 
 #pragma endregion
 
 public:
+#pragma region EmptyFolders
+
+	static void FindEmptyFoldersUnder(FName RootPath, const FPathExclusionMatcher& ExclusionMatcher, TArray<FName>& OutEmptyFolderPaths);
+	static int32 DeleteEmptyFolders(const TArray<FName>& EmptyFolderPaths, TArray<FName>& OutFailedFolderPaths);
+
+#pragma endregion
+
 #pragma region ProccessDataForAdvanceDelectionTab
 
-	bool DeleteSingleAssetForAssetList(const FAssetData& AssetDataToDelete);
-	bool DeleteMultipleAssetsForAssetList(const TArray<FAssetData>& AssetsToDelete);
+	TArray<EAssetDeletionResult> DeleteAssetsForAssetList(const TArray<FAssetData>& AssetsToDelete);
 	void ListUnusedAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, TArray<TSharedPtr<FAssetData>>& OutUnusedAssetsData);
-	void ListSameNameAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, TArray<TSharedPtr<FAssetData>>& OutSameNameAssetsData);
+	void ListUnreachableAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, TArray<TSharedPtr<FAssetData>>& OutUnreachableAssetsData);
+	void ListSameNameAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, TArray<TSharedPtr<FAssetData>>& OutSameNameAssetsData,
+		TArray<struct FAssetDataGroup>& OutAssetGroups);
+	void ListIdenticalContentAssetsForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, TArray<TSharedPtr<FAssetData>>& OutIdenticalAssetsData,
+		TArray<struct FAssetDataGroup>& OutAssetGroups);
+	void ListIdenticalContentAssetsForAssetListAsync(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter,
+		TFunction<void(TArray<TSharedPtr<FAssetData>>&& IdenticalAssetsData, TArray<struct FAssetDataGroup>&& AssetGroups)>&& OnCompleted);
 	void SyncCBToClickedAssetForAssetList(const FString& AssetPathToSync);
 
+private:
+	template<typename KeyType>
+	void GroupAssetsByKey(const TArray<TSharedPtr<FAssetData>>& AssetDataToGroup, TFunctionRef<bool(int32 AssetIndex, KeyType& OutKey)> GetGroupKey,
+		TArray<TSharedPtr<FAssetData>>& OutGroupedAssetsData, TArray<struct FAssetDataGroup>& OutAssetGroups);
+	static void GatherPackagesForAssetList(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, TArray<FName>& OutPackageNames,
+		TArray<int32>& OutAssetPackageIndices);
+	void GroupAssetsByContentKey(const TArray<TSharedPtr<FAssetData>>& AssetDataToFilter, const TArray<int32>& AssetPackageIndices,
+		const TArray<FPackageContentKey>& ContentKeys, TArray<TSharedPtr<FAssetData>>& OutIdenticalAssetsData, TArray<struct FAssetDataGroup>& OutAssetGroups);
+
+	/** 不可达资产检测的根 */
+	FAssetReachabilityRoots AssetReachabilityRoots;
+
+	/** 内容重复检测的哈希缓存，重新扫描时只读取变化过的包 */
+	FPackageContentHashCache PackageContentHashCache;
+
+#pragma endregion
+
+public:
+#pragma region RedirectorFixup
+
+	FRedirectorFixup& GetRedirectorFixup() { return RedirectorFixup; }
+
+private:
+	FRedirectorFixup RedirectorFixup;
+
+#pragma endregion
+
+public:
+#pragma region AssetReferenceIndex
+
+	const FAssetReferenceIndex& GetUpToDateAssetReferenceIndex();
+
+private:
+	FAssetReferenceIndex AssetReferenceIndex;
+	TSharedPtr<class FUnusedAssetScanTask> UnusedAssetScanTask;
+
+	/** 注册表扫描完成后在后台从快照恢复索引 */
+	TFuture<void> AssetReferenceIndexLoadFuture;
+	FDelegateHandle PreExitDelegateHandle;
+
+	/** 已登记在 Asset Manager 完成初始扫描后恢复快照，避免重复登记 */
+	bool bIsWaitingForAssetManagerScan = false;
+
+	/** 索引中的 Manage 依赖边是在 Asset Manager 完成初始扫描后收集的 */
+	bool bIndexHasAllPrimaryAssetReferencers = false;
+
+	void StartLoadingAssetReferenceIndexSnapshot();
+	void LoadAssetReferenceIndexSnapshotAsync();
+	void UpdateIndexPrimaryAssetReferencers();
+	void WaitForAssetReferenceIndexSnapshot();
+	void SaveAssetReferenceIndexSnapshot();
+	static FString GetAssetReferenceIndexSnapshotPath();
+
+	void RegisterAssetRegistryEvents();
+	void UnregisterAssetRegistryEvents();
+
+	void OnAssetAdded(const FAssetData& AssetData);
+	void OnAssetRemoved(const FAssetData& AssetData);
+	void OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	void OnAssetUpdated(const FAssetData& AssetData);
+	void OnAssetRegistryFilesLoaded();
+	void InvalidateIndexedPackage(FName PackageName);
+
 #pragma endregion
 };
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PathExclusionMatcher.h"
+#include "SuperManagerCommandlet.generated.h"
+
+class FJsonObject;
+class FSuperManagerModule;
+
+/**
+ * 无界面的资产清理工具，供构建机夜间运行
+ * UnrealEditor-Cmd <Project> -run=SuperManager -nullrhi [-Apply] [-Paths=/Game/A+/Game/B]
+ *     [-Tasks=Redirectors+Unused+EmptyFolders+SameName+IdenticalContent]
+ *     [-ExcludeFolders=Name1+Name2] [-ExcludePrefixes=/Game/ThirdParty] [-RedirectorTimeout=<Seconds>] [-Report=<File>]
+ * 默认只检查并输出报告（dry-run），加 -Apply 时才修复重定向器、删除未使用资产和空文件夹
+ * 报告为 JSON，默认写入 Saved/SuperManager/CleanupReport.json
+ */
+UCLASS()
+class SUPERMANAGER_API USuperManagerCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	USuperManagerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	void RunRedirectorTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report);
+	void RunUnusedAssetTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report);
+	void RunEmptyFolderTask(const TSharedRef<FJsonObject>& Report);
+	void RunSameNameTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report);
+	void RunIdenticalContentTask(FSuperManagerModule& SuperManagerModule, const TSharedRef<FJsonObject>& Report);
+
+	void GatherAssetsUnderPaths(TArray<TSharedPtr<FAssetData>>& OutAssetsData) const;
+
+	TArray<FString> PackagePaths;
+	FPathExclusionMatcher PathExclusionMatcher;
+	bool bApply = false;
+	int32 NumFailures = 0;
+
+	/** 等待重定向器修复的最长时间，超时后停止修复并计为失败 */
+	static constexpr float DefaultRedirectorTimeoutSeconds = 1800.f;
+	float RedirectorTimeoutSeconds = DefaultRedirectorTimeoutSeconds;
+};
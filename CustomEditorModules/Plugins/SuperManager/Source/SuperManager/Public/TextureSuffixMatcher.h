@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 纹理对应的材质通道
+ */
+enum class ETextureChannel : uint8
+{
+	None,
+	BaseColor,
+	Metallic,
+	Roughness,
+	Normal,
+	AmbientOcclusion,
+	ORM
+};
+
+/**
+ * 纹理通道后缀匹配
+ * 所有后缀按字符倒序编译成一棵前缀树，分类时从名称末尾向前走一遍，取最长的匹配，不区分大小写
+ */
+class SUPERMANAGER_API FTextureSuffixMatcher
+{
+public:
+	void Reset();
+	void AddSuffixes(const TArray<FString>& Suffixes, ETextureChannel Channel);
+
+	ETextureChannel Classify(FStringView TextureName, int32* OutSuffixLength = nullptr) const;
+
+private:
+	struct FTrieNode
+	{
+		TMap<TCHAR, int32> Children;
+		ETextureChannel Channel = ETextureChannel::None;
+	};
+
+	/** 0 号节点为根 */
+	TArray<FTrieNode> ReversedSuffixTrieNodes;
+};
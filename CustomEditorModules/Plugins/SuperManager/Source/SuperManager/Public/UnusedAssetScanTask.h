@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "Async/Future.h"
+#include <atomic>
+
+class FAssetReferenceIndex;
+class FPathExclusionMatcher;
+class SNotificationItem;
+
+/**
+ * 后台查找未使用资产
+ * 在线程池中分块检查引用数，通过带取消按钮的通知报告进度，结果回到游戏线程交给回调处理
+ */
+class SUPERMANAGER_API FUnusedAssetScanTask : public TSharedFromThis<FUnusedAssetScanTask>
+{
+public:
+	DECLARE_DELEGATE_OneParam(FOnScanCompleted, const TArray<FAssetData>& /*UnusedAssetsData*/);
+
+	FUnusedAssetScanTask(TArray<FAssetData>&& InAssetsDataToScan, FAssetReferenceIndex& InReferenceIndex,
+		const FPathExclusionMatcher& InPathExclusionMatcher, const FOnScanCompleted& InOnScanCompleted);
+
+	void Start();
+	void Cancel();
+	void CancelAndWait();
+	bool IsRunning() const { return bIsRunning; }
+
+private:
+	void Run();
+	void PostProgress(const FString& ProgressText);
+	void Finish();
+
+	/** 每处理一块检查一次取消标记并更新一次进度 */
+	static constexpr int32 ChunkSize = 2048;
+
+	TArray<FAssetData> AssetsDataToScan;
+	TArray<FAssetData> UnusedAssetsData;
+	TArray<FAssetIdentifier> PrimaryAssetReferencers;
+
+	FAssetReferenceIndex& ReferenceIndex;
+	const FPathExclusionMatcher& PathExclusionMatcher;
+	FOnScanCompleted OnScanCompleted;
+
+	TSharedPtr<SNotificationItem> ProgressNotification;
+	TFuture<void> ScanFuture;
+
+	std::atomic<bool> bCancelRequested {false};
+	bool bIsRunning = false;
+};
@@ -47,6 +47,10 @@ public class SuperManager : ModuleRules
 			{
 				"CoreUObject",
 				"Engine",
+				"AssetRegistry",
+				"DeveloperToolSettings",	// ProjectPackagingSettings
+				"SourceControl",
+				"Json",
 				"Slate",
 				"SlateCore",
 			}